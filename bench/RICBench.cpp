@@ -0,0 +1,72 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <static/vsa/RIC.hpp>
+
+/// Microbenchmark of the RIC lattice operations: runs join, meet and widen
+/// over the same pairs of random RICs and prints the time per call.
+
+/// A mix of constants, small ranges and ranges with an infinite bound, as
+/// seen in value sets of registers and stack offsets
+static RIC randomRIC(std::mt19937_64 &rng) {
+    int offset = (int)(rng() % 4097) - 2048;
+
+    switch (rng() % 4) {
+    case 0:
+        return RIC(offset);
+    case 1:
+        return RIC(1 << (rng() % 5), 0, (int64_t)(rng() % 64), offset);
+    case 2:
+        return RIC(1 + rng() % 16, 0, Bound::plus_infinity(), offset);
+    default:
+        return RIC(1 + rng() % 16, Bound::minus_infinity(),
+                   Bound::plus_infinity(), 0);
+    }
+}
+
+template <typename Op>
+static void run(const char *name, int rounds, const std::vector<RIC> &lhs,
+                const std::vector<RIC> &rhs, Op op) {
+    // Sum the results so that the calls aren't optimised away
+    int64_t checksum = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < lhs.size(); i++) {
+            // Joins can adjust their argument, so work on copies of both
+            RIC result = lhs[i], other = rhs[i];
+            op(result, other);
+            checksum += result.stride + result.offset;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double calls = (double)rounds * lhs.size();
+    double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+    std::printf("%-6s %8.2f ns/call (checksum %lld)\n", name, ns / calls,
+                (long long)checksum);
+}
+
+int main(int argc, char **argv) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+
+    std::mt19937_64 rng(20261016);
+    std::vector<RIC> lhs, rhs;
+    for (int i = 0; i < 4096; i++) {
+        lhs.push_back(randomRIC(rng));
+        rhs.push_back(randomRIC(rng));
+    }
+
+    run("join", rounds, lhs, rhs,
+        [](RIC &result, RIC &other) { result.joinWith(other); });
+    run("meet", rounds, lhs, rhs,
+        [](RIC &result, RIC &other) { result.meetWith(other); });
+    run("widen", rounds, lhs, rhs,
+        [](RIC &result, RIC &other) { result.widenWith(other); });
+
+    return 0;
+}
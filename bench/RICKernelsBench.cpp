@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <static/vsa/RICKernels.hpp>
+
+/// Microbenchmark of the RIC kernels in `RICKernels.hpp`: runs every kernel
+/// over the same pairs of random RICs and prints the time per call.
+
+typedef RIC (*Kernel)(RIC, RIC, int);
+
+struct KernelCase {
+    const char *name;
+    Kernel kernel;
+};
+
+static const KernelCase CASES[] = {
+    {"add", RICKernels::add},     {"sub", RICKernels::sub},
+    {"mul", RICKernels::mul},     {"div", RICKernels::div},
+    {"udiv", RICKernels::udiv},   {"rem", RICKernels::rem},
+    {"urem", RICKernels::urem},   {"shl", RICKernels::shl},
+    {"ashr", RICKernels::ashr},   {"lshr", RICKernels::lshr},
+    {"and", RICKernels::bitAnd},  {"or", RICKernels::bitOr},
+    {"xor", RICKernels::bitXor},
+};
+
+/// A mix of constants, small ranges and ranges with an infinite bound, as
+/// seen in value sets of registers and stack offsets
+static RIC randomRIC(std::mt19937_64 &rng) {
+    int offset = (int)(rng() % 4097) - 2048;
+
+    switch (rng() % 4) {
+    case 0:
+        return RIC(offset);
+    case 1:
+        return RIC(1 << (rng() % 5), 0, (int64_t)(rng() % 64), offset);
+    case 2:
+        return RIC(1 + rng() % 16, 0, Bound::plus_infinity(), offset);
+    default:
+        return RIC(1 + rng() % 16, Bound::minus_infinity(),
+                   Bound::plus_infinity(), 0);
+    }
+}
+
+int main(int argc, char **argv) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+
+    std::mt19937_64 rng(20261016);
+    std::vector<RIC> lhs, rhs, shifts;
+    for (int i = 0; i < 4096; i++) {
+        lhs.push_back(randomRIC(rng));
+        rhs.push_back(randomRIC(rng));
+        shifts.push_back(RIC((int)(rng() % 8)));
+    }
+
+    for (const KernelCase &kernel : CASES) {
+        // Shift amounts are almost always small constants
+        bool isShift = kernel.kernel == RICKernels::shl ||
+                       kernel.kernel == RICKernels::ashr ||
+                       kernel.kernel == RICKernels::lshr;
+        const std::vector<RIC> &rights = isShift ? shifts : rhs;
+
+        // Sum the results so that the calls aren't optimised away
+        int64_t checksum = 0;
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++) {
+            for (size_t i = 0; i < lhs.size(); i++) {
+                RIC result =
+                    kernel.kernel(lhs[i], rights[i], RICKernels::WORD_WIDTH);
+                checksum += result.stride + result.offset;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double calls = (double)rounds * lhs.size();
+        double ns =
+            std::chrono::duration<double, std::nano>(end - begin).count();
+        std::printf("%-6s %8.2f ns/call (checksum %lld)\n", kernel.name,
+                    ns / calls, (long long)checksum);
+    }
+
+    return 0;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Util/GeneralType.h>
+
 #include <static/asi/ASIType.hpp>
 #include <static/vsa/AbstractStore.hpp>
 #include <static/vsa/ValueSet.hpp>
@@ -8,7 +10,11 @@ class ASI {
   public:
     ASI(std::map<SVF::NodeID, std::pair<ValueSet, size_t>> _accesses,
         std::vector<ALoc> _alocs)
-        : accesses(_accesses), alocs(_alocs) {}
+        : accesses(_accesses), alocs(_alocs) {
+        for (ALoc aloc : this->alocs) {
+            this->table.intern(aloc);
+        }
+    }
 
     std::map<uint64_t, std::vector<ALoc>> findALocs(ValueSet);
     ASIType *infer(ValueSet, size_t, ALoc);
@@ -26,6 +32,9 @@ class ASI {
   private:
     std::map<SVF::NodeID, std::pair<ValueSet, size_t>> accesses;
     std::vector<ALoc> alocs;
+    /// IDs of `alocs`, and an index of them for finding the a-locs that an
+    /// access overlaps
+    ALocTable table;
 
     std::map<ALoc, ASIType *> regionsToTypes;
 };
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <static/vsa/RIC.hpp>
+#include <static/vsa/RegionMap.hpp>
+
+/// @brief A "quasi-variable" that could contain a range of values.
+struct ALoc {
+    RegionID region;
+    int offset;
+    size_t size;
+
+    bool operator<(const ALoc &) const;
+    bool operator==(const ALoc &) const;
+
+    bool in(RIC);
+    std::string toString();
+};
+
+/// @brief Hashes the region, offset and size of an a-loc, for a-locs used
+/// as keys of unordered containers.
+struct ALocHash {
+    size_t operator()(const ALoc &) const;
+};
+
+/// Dense ID of an interned a-loc
+typedef uint32_t ALocID;
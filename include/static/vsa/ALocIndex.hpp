@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <static/vsa/ALoc.hpp>
+#include <static/vsa/RIC.hpp>
+
+/// @brief An index of a-locs by the bytes they cover, for finding every
+/// a-loc that a memory access could overlap. The a-locs of each region are
+/// kept sorted by offset, so a query is a binary search followed by a scan
+/// of the a-locs which start in (or just before) the accessed range.
+class ALocIndex {
+  public:
+    void insert(ALocID, const ALoc &);
+
+    /// @brief Find every a-loc in `region` that shares at least one byte
+    /// with `[ric.lower(), ric.upper()]`, in order of offset.
+    std::vector<ALocID> overlapping(RegionID region, const RIC &ric) const;
+
+    size_t size() const { return this->count; }
+
+  private:
+    struct Entry {
+        int64_t offset;
+        int64_t end;
+        ALocID id;
+    };
+
+    struct Region {
+        /// Sorted by offset, then end
+        std::vector<Entry> entries;
+        /// Size of the largest a-loc, which bounds how far before the
+        /// accessed range an overlapping a-loc can start
+        int64_t maxSize = 0;
+    };
+
+    std::unordered_map<RegionID, Region> regions;
+    size_t count = 0;
+};
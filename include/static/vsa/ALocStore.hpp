@@ -0,0 +1,368 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include <static/vsa/ALocTable.hpp>
+#include <static/vsa/StoreArena.hpp>
+#include <static/vsa/StoreKernels.hpp>
+#include <static/vsa/ValueSetTable.hpp>
+
+/// @brief The values of a-locs, indexed by their dense IDs in the
+/// `ALocTable` of the analysis, which is passed in wherever a store is
+/// accessed by a-loc rather than by ID.
+/// Values are stored in chunks of `CHUNK` handles, each with a bitset of
+/// which a-locs are present in the store, so looking up an a-loc is two
+/// array indexes rather than a tree walk.
+///
+/// As with `StoreMap`, chunks and the list of chunks are shared between
+/// copies, and writing to a shared store only copies the chunk being
+/// written to. Chunks are allocated from the current `StoreArena`. Chunks
+/// also track which of their entries were written since
+/// they were copied, so comparing two chunks copied from the same chunk
+/// only looks at the entries that either of them has written to.
+class ALocStore {
+  public:
+    static const size_t CHUNK = StoreKernels::CHUNK;
+
+    /// A view of one (a-loc, value) entry, with the value under the same
+    /// field name as the entries of a `std::map`. The a-loc itself can be
+    /// looked up from `id` in the store's `ALocTable`.
+    struct Entry {
+        const ValueSetRef &second;
+        ALocID id;
+    };
+
+    class iterator {
+      public:
+        iterator(const ALocStore *_store, ALocID _id)
+            : store(_store), id(_id) {
+            this->skipAbsent();
+        }
+
+        Entry operator*() const {
+            const Chunk &chunk = *this->store->root->chunks[this->id / CHUNK];
+            return {chunk.values[this->id % CHUNK], this->id};
+        }
+
+        iterator &operator++() {
+            this->id++;
+            this->skipAbsent();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator prev = *this;
+            ++(*this);
+            return prev;
+        }
+
+        bool operator==(const iterator &rhs) const {
+            return this->id == rhs.id;
+        }
+
+        bool operator!=(const iterator &rhs) const {
+            return this->id != rhs.id;
+        }
+
+      private:
+        /// Move to the next a-loc in the store, using the presence bitsets
+        /// to skip over absent a-locs a chunk at a time
+        void skipAbsent() {
+            ALocID end = this->store->capacity();
+
+            while (this->id < end) {
+                const Chunk &chunk =
+                    *this->store->root->chunks[this->id / CHUNK];
+                uint64_t present = chunk.present >> (this->id % CHUNK);
+
+                if (present != 0) {
+                    this->id += __builtin_ctzll(present);
+                    return;
+                }
+
+                this->id = (this->id / CHUNK + 1) * CHUNK;
+            }
+
+            this->id = end;
+        }
+
+        const ALocStore *store;
+        ALocID id;
+    };
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, this->capacity()); }
+
+    size_t size() const { return this->root ? this->root->count : 0; }
+    bool empty() const { return this->size() == 0; }
+    void clear() { this->root.reset(); }
+
+    bool contains(ALocID id) const {
+        return id < this->capacity() &&
+               (this->root->chunks[id / CHUNK]->present >> (id % CHUNK)) & 1;
+    }
+
+    iterator find(ALocID id) const {
+        return this->contains(id) ? iterator(this, id) : this->end();
+    }
+
+    /// Find an a-loc without interning it, so a-locs that `table` has
+    /// never seen are simply absent
+    iterator find(const ALoc &aloc, const ALocTable &table) const {
+        ALocID id = table.lookup(aloc);
+        return id == ALocTable::ABSENT ? this->end() : this->find(id);
+    }
+
+    /// @brief Find the value of an a-loc, adding it with an empty value set
+    /// if it is not in the store yet, as with `std::map`. The chunk holding
+    /// the a-loc is unshared, so the returned reference can be written to.
+    ValueSetRef &operator[](ALocID id) {
+        uint64_t bit = (uint64_t)1 << (id % CHUNK);
+        Chunk &chunk = this->mutableChunk(id / CHUNK, bit);
+
+        if (!(chunk.present & bit)) {
+            chunk.present |= bit;
+            this->root->count++;
+        }
+
+        return chunk.values[id % CHUNK];
+    }
+
+    /// @brief Whether both stores hold exactly the same a-locs and values.
+    /// Shared chunks are skipped, and other chunks are compared in bulk.
+    bool operator==(const ALocStore &rhs) const {
+        if (this->root == rhs.root) {
+            return true;
+        }
+
+        if (this->size() != rhs.size()) {
+            return false;
+        }
+
+        size_t chunks = std::max(this->chunkCount(), rhs.chunkCount());
+        for (size_t i = 0; i < chunks; i++) {
+            const Chunk *lhsChunk = this->chunkAt(i);
+            const Chunk *rhsChunk = rhs.chunkAt(i);
+
+            if (lhsChunk == rhsChunk) {
+                continue;
+            }
+
+            if (!lhsChunk || !rhsChunk) {
+                // Absent a-locs always hold the empty value set, so a
+                // missing chunk only matches a chunk with nothing in it
+                const Chunk *chunk = lhsChunk ? lhsChunk : rhsChunk;
+                if (chunk->present != 0) {
+                    return false;
+                }
+
+                continue;
+            }
+
+            if (lhsChunk->present != rhsChunk->present ||
+                differing(*lhsChunk, *rhsChunk) != 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /// @brief Overwrite each value in this store with `combine(lhs, rhs)`,
+    /// where `rhs` is the value of the same a-loc in `rhs`. Values that are
+    /// already equal are skipped, so `combine` must leave a value unchanged
+    /// when combined with itself (as with join, widen and narrow). Chunks
+    /// are only unshared if one of their values actually changes.
+    /// @param addMissing whether a-locs only in `rhs` are copied over
+    /// @return Whether this store changed
+    template <typename Combine>
+    bool combineWith(const ALocStore &rhs, Combine combine, bool addMissing) {
+        if (this->root == rhs.root || rhs.empty()) {
+            return false;
+        }
+
+        if (this->empty()) {
+            if (addMissing) {
+                this->root = rhs.root;
+                return true;
+            }
+
+            return false;
+        }
+
+        bool changed = false;
+
+        for (size_t i = 0; i < rhs.chunkCount(); i++) {
+            const Chunk &rhsChunk = *rhs.root->chunks[i];
+            const Chunk *lhsChunk = this->chunkAt(i);
+
+            if (lhsChunk == &rhsChunk) {
+                continue;
+            }
+
+            uint64_t lhsPresent = lhsChunk ? lhsChunk->present : 0;
+            uint64_t added = addMissing ? rhsChunk.present & ~lhsPresent : 0;
+            uint64_t differ = lhsPresent & rhsChunk.present;
+
+            if (differ != 0) {
+                differ &= differing(*lhsChunk, rhsChunk);
+            }
+
+            // Combine values first, so that values which come out the same
+            // don't unshare the chunk
+            ValueSetRef results[CHUNK];
+            uint64_t updated = 0;
+
+            while (differ != 0) {
+                size_t j = __builtin_ctzll(differ);
+                differ &= differ - 1;
+
+                results[j] = combine(lhsChunk->values[j], rhsChunk.values[j]);
+                if (results[j] != lhsChunk->values[j]) {
+                    updated |= (uint64_t)1 << j;
+                }
+            }
+
+            if (added == 0 && updated == 0) {
+                continue;
+            }
+
+            changed = true;
+
+            Chunk &chunk = this->mutableChunk(i, added | updated);
+            chunk.present |= added;
+            this->root->count += __builtin_popcountll(added);
+
+            while (added != 0) {
+                size_t j = __builtin_ctzll(added);
+                added &= added - 1;
+
+                chunk.values[j] = rhsChunk.values[j];
+            }
+
+            while (updated != 0) {
+                size_t j = __builtin_ctzll(updated);
+                updated &= updated - 1;
+
+                chunk.values[j] = results[j];
+            }
+        }
+
+        return changed;
+    }
+
+  private:
+    struct Chunk {
+        /// Bit `i` is set iff the `i`th a-loc of the chunk is in the store.
+        /// Absent a-locs always hold the empty value set.
+        uint64_t present = 0;
+        ValueSetRef values[CHUNK];
+
+        /// Stamp of this chunk's contents, which changes on every write, so
+        /// two chunks with the same version hold the same entries
+        uint64_t version = nextVersion();
+        /// Version of the chunk this one was copied from (0 if none)
+        uint64_t baseVersion = 0;
+        /// Entries written (or added) since this chunk was copied
+        uint64_t dirty = 0;
+    };
+
+    struct Node {
+        typedef std::pmr::polymorphic_allocator<std::byte> allocator_type;
+
+        explicit Node(const allocator_type &allocator) : chunks(allocator) {}
+        Node(const Node &rhs, const allocator_type &allocator)
+            : chunks(rhs.chunks, allocator), count(rhs.count) {}
+
+        std::pmr::vector<std::shared_ptr<Chunk>> chunks;
+        size_t count = 0;
+    };
+
+    static uint64_t nextVersion() {
+        static uint64_t version = 0;
+        return ++version;
+    }
+
+    /// @brief Find the entries of two chunks that could hold different
+    /// values. If one chunk is a copy of the other, or both are copies of
+    /// the same chunk, only the entries written since the copy can differ.
+    /// @return A mask with bit `i` set iff the `i`th values differ
+    static uint64_t differing(const Chunk &lhs, const Chunk &rhs) {
+        uint64_t candidates = ~(uint64_t)0;
+
+        if (rhs.baseVersion == lhs.version) {
+            candidates = rhs.dirty;
+        } else if (lhs.baseVersion == rhs.version) {
+            candidates = lhs.dirty;
+        } else if (lhs.baseVersion != 0 &&
+                   lhs.baseVersion == rhs.baseVersion) {
+            candidates = lhs.dirty | rhs.dirty;
+        }
+
+        if (candidates == ~(uint64_t)0) {
+            return StoreKernels::diffMask(lhs.values, rhs.values, CHUNK);
+        }
+
+        uint64_t diff = 0;
+        while (candidates != 0) {
+            size_t i = __builtin_ctzll(candidates);
+            candidates &= candidates - 1;
+
+            if (lhs.values[i] != rhs.values[i]) {
+                diff |= (uint64_t)1 << i;
+            }
+        }
+
+        return diff;
+    }
+
+    size_t chunkCount() const {
+        return this->root ? this->root->chunks.size() : 0;
+    }
+
+    /// One past the largest ID that could be in the store
+    ALocID capacity() const { return this->chunkCount() * CHUNK; }
+
+    const Chunk *chunkAt(size_t index) const {
+        return index < this->chunkCount() ? this->root->chunks[index].get()
+                                          : nullptr;
+    }
+
+    /// @brief Make one chunk (and the list of chunks) unique to this store,
+    /// creating it if the store doesn't reach that far yet.
+    /// @param written mask of the entries about to be written
+    Chunk &mutableChunk(size_t index, uint64_t written) {
+        if (!this->root) {
+            this->root = StoreArena::make<Node>();
+        } else if (this->root.use_count() > 1) {
+            this->root = StoreArena::make<Node>(*this->root);
+        }
+
+        std::pmr::vector<std::shared_ptr<Chunk>> &chunks = this->root->chunks;
+        while (chunks.size() <= index) {
+            chunks.push_back(StoreArena::make<Chunk>());
+        }
+
+        std::shared_ptr<Chunk> &chunk = chunks[index];
+        if (chunk.use_count() > 1) {
+            auto copy = StoreArena::make<Chunk>(*chunk);
+            copy->baseVersion = chunk->version;
+            copy->dirty = 0;
+            chunk = copy;
+        }
+
+        // Any write gives the chunk a new version, since other chunks may
+        // have been copied from its current contents
+        chunk->version = nextVersion();
+        chunk->dirty |= written;
+
+        return *chunk;
+    }
+
+    std::shared_ptr<Node> root;
+};
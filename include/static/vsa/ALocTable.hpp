@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
+#include <static/vsa/ALoc.hpp>
+#include <static/vsa/ALocIndex.hpp>
+
+/// @brief A table of every a-loc seen so far by one analysis. Each a-loc is
+/// given a dense 32-bit ID the first time it is interned, so abstract stores
+/// can index their a-locs by position instead of comparing them. Every
+/// interned a-loc is also added to an `ALocIndex`, for finding the a-locs
+/// that a memory access overlaps.
+class ALocTable {
+  public:
+    /// ID returned by `lookup` for a-locs that have not been interned
+    static const ALocID ABSENT = UINT32_MAX;
+
+    ALocID intern(const ALoc &);
+    const ALoc &lookup(ALocID id) const { return this->alocs[id]; }
+
+    /// @brief Find the ID of an a-loc without interning it.
+    /// @return `ABSENT` if the a-loc has not been interned
+    ALocID lookup(const ALoc &aloc) const {
+        auto it = this->ids.find(aloc);
+        return it == this->ids.end() ? ABSENT : it->second;
+    }
+
+    size_t size() const { return this->alocs.size(); }
+
+    const ALocIndex &getIndex() const { return this->index; }
+
+  private:
+    // `std::deque` never moves its elements, so references returned by
+    // `lookup` stay valid as the table grows
+    std::deque<ALoc> alocs;
+    std::unordered_map<ALoc, ALocID, ALocHash> ids;
+    ALocIndex index;
+};
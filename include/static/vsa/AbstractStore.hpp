@@ -1,39 +1,37 @@
 #pragma once
 
 #include <map>
+#include <string>
 
+#include <static/vsa/ALocStore.hpp>
+#include <static/vsa/ALocTable.hpp>
+#include <static/vsa/RegisterFile.hpp>
 #include <static/vsa/ValueSet.hpp>
-
-/// @brief A "quasi-variable" that could contain a range of values.
-struct ALoc {
-    uint64_t region;
-    int offset;
-    size_t size;
-
-    bool operator<(const ALoc &) const;
-    bool operator==(ALoc &);
-
-    bool in(RIC);
-    std::string toString();
-};
+#include <static/vsa/ValueSetTable.hpp>
 
 /// @brief A mapping of registers and abstract locations to values, which
-/// could then represent integers or addresses.
+/// could then represent integers or addresses. A-locs are indexed by their
+/// dense IDs in the `ALocTable` of the analysis. The a-loc store is
+/// persistent and the register file is a fixed array of handles, so copying
+/// a store is O(1), and stores copied from each other share every part that
+/// neither has written to.
 struct AbstractStore {
-    std::map<ALoc, ValueSet> alocs;
-    std::map<std::string, ValueSet> registers;
+    ALocStore alocs;
+    RegisterFile registers;
 
     bool operator==(AbstractStore &);
 
-    ValueSet getALocSet(ALoc aloc) {
-        return this->alocs[aloc];
+    /// Reads go through `find`, since `operator[]` would unshare the map
+    ValueSet getALocSet(ALoc aloc, const ALocTable &table) {
+        auto it = this->alocs.find(aloc, table);
+        return it == this->alocs.end() ? ValueSet() : (*it).second.get();
     }
 
-    ValueSet getRegisterSet(std::string reg) {
-        return this->registers[reg];
-    }
+    ValueSet getRegisterSet(Register reg) { return this->registers[reg]; }
 
-    void joinWith(AbstractStore &);
-    void widenWith(AbstractStore &);
-    void narrowWith(AbstractStore &);
+    /// Join, widen and narrow update this store in place, and return
+    /// whether it changed
+    bool joinWith(AbstractStore &);
+    bool widenWith(AbstractStore &);
+    bool narrowWith(AbstractStore &);
 };
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+/// @brief A 64-bit bound of a RIC. The two extremes of `int64_t` are
+/// reserved as sentinels for -inf and +inf, and all arithmetic saturates
+/// to those sentinels instead of overflowing, so a bound is always a single
+/// machine word.
+class Bound {
+  public:
+    constexpr Bound() : value(0) {}
+    constexpr Bound(int64_t _value) : value(_value) {}
+
+    static constexpr Bound plus_infinity() { return Bound(PLUS_INF); }
+    static constexpr Bound minus_infinity() { return Bound(MINUS_INF); }
+
+    constexpr bool is_plus_infinity() const { return this->value == PLUS_INF; }
+    constexpr bool is_minus_infinity() const {
+        return this->value == MINUS_INF;
+    }
+    constexpr bool is_infinity() const {
+        return this->is_plus_infinity() || this->is_minus_infinity();
+    }
+    constexpr bool is_zero() const { return this->value == 0; }
+
+    constexpr int64_t getIntNumeral() const { return this->value; }
+
+    std::string to_string() const {
+        if (this->is_plus_infinity()) {
+            return "inf";
+        } else if (this->is_minus_infinity()) {
+            return "-inf";
+        }
+
+        return std::to_string(this->value);
+    }
+
+    constexpr Bound operator-() const {
+        if (this->is_plus_infinity()) {
+            return minus_infinity();
+        } else if (this->is_minus_infinity()) {
+            return plus_infinity();
+        }
+
+        return Bound(-this->value);
+    }
+
+    friend constexpr Bound operator+(Bound lhs, Bound rhs) {
+        // Infinities absorb any finite value; if both sides are infinite,
+        // the left-hand side wins
+        if (lhs.is_infinity()) {
+            return lhs;
+        } else if (rhs.is_infinity()) {
+            return rhs;
+        }
+
+        int64_t result = 0;
+        if (__builtin_add_overflow(lhs.value, rhs.value, &result)) {
+            return rhs.value > 0 ? plus_infinity() : minus_infinity();
+        }
+
+        return Bound(result);
+    }
+
+    friend constexpr Bound operator-(Bound lhs, Bound rhs) {
+        return lhs + (-rhs);
+    }
+
+    friend constexpr Bound operator*(Bound lhs, Bound rhs) {
+        // 0 * inf is treated as 0, as in SVF
+        if (lhs.is_zero() || rhs.is_zero()) {
+            return Bound(0);
+        }
+
+        bool negative = (lhs.value < 0) != (rhs.value < 0);
+        if (lhs.is_infinity() || rhs.is_infinity()) {
+            return negative ? minus_infinity() : plus_infinity();
+        }
+
+        int64_t result = 0;
+        if (__builtin_mul_overflow(lhs.value, rhs.value, &result)) {
+            return negative ? minus_infinity() : plus_infinity();
+        }
+
+        return Bound(result);
+    }
+
+    friend constexpr Bound operator/(Bound lhs, Bound rhs) {
+        if (lhs.is_zero()) {
+            return Bound(0);
+        }
+
+        bool negative = (lhs.value < 0) != (rhs.value < 0);
+        if (lhs.is_infinity() || rhs.is_zero()) {
+            return negative ? minus_infinity() : plus_infinity();
+        }
+
+        if (rhs.is_infinity()) {
+            return Bound(0);
+        }
+
+        return Bound(lhs.value / rhs.value);
+    }
+
+    friend constexpr bool operator==(Bound lhs, Bound rhs) {
+        return lhs.value == rhs.value;
+    }
+    friend constexpr bool operator!=(Bound lhs, Bound rhs) {
+        return lhs.value != rhs.value;
+    }
+    friend constexpr bool operator<(Bound lhs, Bound rhs) {
+        return lhs.value < rhs.value;
+    }
+    friend constexpr bool operator<=(Bound lhs, Bound rhs) {
+        return lhs.value <= rhs.value;
+    }
+    friend constexpr bool operator>(Bound lhs, Bound rhs) {
+        return lhs.value > rhs.value;
+    }
+    friend constexpr bool operator>=(Bound lhs, Bound rhs) {
+        return lhs.value >= rhs.value;
+    }
+
+  private:
+    static constexpr int64_t PLUS_INF = std::numeric_limits<int64_t>::max();
+    static constexpr int64_t MINUS_INF = std::numeric_limits<int64_t>::min();
+
+    int64_t value;
+};
+
+static_assert(sizeof(Bound) == sizeof(int64_t), "Bound must be one word");
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <Graphs/ICFG.h>
+#include <Util/GeneralType.h>
+#include <static/vsa/Intrinsics.hpp>
+#include <static/vsa/RegisterFile.hpp>
+#include <static/vsa/ValueSetTable.hpp>
+#include <static/vsa/VarRole.hpp>
+
+/// Dense number of a basic block, used to index `BlockStates`
+typedef uint32_t BlockID;
+
+/// The kinds of decoded instruction - one for each kind of SVF statement
+/// that changes the abstract state, plus one for calls
+enum class Opcode : uint8_t {
+    /// `res = args[0]`
+    Copy,
+    /// `res = args[0] <code> args[1]`, where `code` is a
+    /// `SVF::BinaryOPStmt::OpCode`
+    Binary,
+    /// `res = args[0] <code> args[1]`, where `code` is a
+    /// `SVF::CmpStmt::Predicate`
+    Cmp,
+    /// `res = args[0] ? args[1] : args[2]`
+    Select,
+    /// `res = *location`
+    Load,
+    /// `*location = args[0]`
+    Store,
+    /// End of the basic block `block`
+    Branch,
+    /// Call to `call`, whose callee is handled as `callee`. Memory
+    /// intrinsics access `size` bytes at `args[0]`, writing `args[1]` or
+    /// reading into `res`, and `scanf` returns `res`.
+    CallSite
+};
+
+/// @brief An SVF variable read by an instruction. Global variables are
+/// constant, so their values are copied into the operand when it is
+/// decoded, rather than looked up every time the instruction is run.
+struct Operand {
+    SVF::NodeID id = 0;
+    bool isGlobal = false;
+    ValueSetRef global;
+};
+
+/// @brief One SVF statement (or call), decoded once into a fixed-size
+/// record with its operands and the meaning of its names already resolved,
+/// so that running it again costs no casts, map lookups or string
+/// comparisons.
+struct Instruction {
+    Opcode opcode;
+    Location location = Location::Other;
+    RegisterAlias alias;
+
+    /// How the callee of a `CallSite` instruction is handled
+    CallKind callee = CallKind::Function;
+    /// Size in bytes of a memory intrinsic's access
+    uint8_t size = 0;
+
+    /// Operator of a `Binary` or `Cmp` instruction
+    uint32_t code = 0;
+
+    SVF::NodeID res = 0;
+    Operand args[3];
+
+    /// Block ended by a `Branch` instruction
+    BlockID block = 0;
+    /// Call node of a `CallSite` instruction
+    const SVF::CallICFGNode *call = nullptr;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/// What a call does to the abstract state, resolved once per call site
+enum class CallKind : uint8_t {
+    /// Call to a lifted function, which is analysed in turn
+    Function,
+    /// Call to a recursive function, which is skipped
+    Recursive,
+    /// Call to any other external function
+    External,
+    /// `ret = __remill_read_memory_*(memory, addr)`
+    MemoryRead,
+    /// `__remill_write_memory_*(memory, addr, value)`
+    MemoryWrite,
+    /// `scanf`, which writes through the pointer in `RSI`
+    Scanf,
+    /// Intrinsics that don't change the abstract state, e.g. barriers
+    Ignored
+};
+
+/// How calls to a named function are handled, and how many bytes of
+/// memory they access
+struct Intrinsic {
+    CallKind kind = CallKind::External;
+    uint8_t size = 0;
+};
+
+/// @brief A global registry of the functions that the analysis handles
+/// specially, mostly Remill intrinsics. Call sites are resolved against it
+/// once, when they are decoded, so supporting another intrinsic is one
+/// call to `add` rather than another string comparison on every call.
+class IntrinsicTable {
+  public:
+    static IntrinsicTable &getTable();
+
+    void add(const std::string &name, Intrinsic intrinsic) {
+        this->intrinsics[name] = intrinsic;
+    }
+
+    /// Find how calls to a function are handled - `nullptr` if they aren't
+    /// handled specially
+    const Intrinsic *lookup(const std::string &) const;
+
+  private:
+    IntrinsicTable();
+
+    std::unordered_map<std::string, Intrinsic> intrinsics;
+};
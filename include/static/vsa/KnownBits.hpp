@@ -0,0 +1,335 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <static/vsa/RICKernels.hpp>
+
+/// Whether value sets track known bits alongside their RICs - set by the
+/// `ENABLE_KNOWN_BITS` CMake option. When disabled, every known-bits
+/// component stays unknown and the reduction is skipped.
+#ifdef VSA_KNOWN_BITS
+constexpr bool KNOWN_BITS_ENABLED = true;
+#else
+constexpr bool KNOWN_BITS_ENABLED = false;
+#endif
+
+/// @brief The bits of a 64-bit value that are known to be 0 or 1. RICs
+/// can't represent the results of masking and flag arithmetic well, so
+/// each RIC in a value set is paired with one of these, and the two are
+/// reduced against each other (see `reduce`).
+struct KnownBits {
+    uint64_t zeros;
+    uint64_t ones;
+
+    /// Nothing is known
+    constexpr KnownBits() : zeros(0), ones(0) {}
+    constexpr KnownBits(uint64_t _zeros, uint64_t _ones)
+        : zeros(_zeros), ones(_ones) {}
+
+    static constexpr KnownBits constant(int64_t value) {
+        return KnownBits(~(uint64_t)value, (uint64_t)value);
+    }
+
+    constexpr uint64_t known() const { return this->zeros | this->ones; }
+
+    constexpr bool isUnknown() const { return this->known() == 0; }
+    constexpr bool isConstant() const { return this->known() == ~(uint64_t)0; }
+
+    /// A bit that is both 0 and 1 means that there are no possible values
+    constexpr bool isConflict() const {
+        return (this->zeros & this->ones) != 0;
+    }
+
+    constexpr int64_t getConstant() const { return (int64_t)this->ones; }
+
+    /// Smallest signed value matching the known bits
+    constexpr int64_t minValue() const {
+        uint64_t unknownSign = ~this->known() & SIGN_BIT;
+        return (int64_t)(this->ones | unknownSign);
+    }
+
+    /// Largest signed value matching the known bits
+    constexpr int64_t maxValue() const {
+        uint64_t unknown = ~this->known() & ~SIGN_BIT;
+        return (int64_t)(this->ones | unknown);
+    }
+
+    /// Number of low bits that are all known
+    constexpr int trailingKnown() const {
+        return this->isConstant() ? 64 : __builtin_ctzll(~this->known());
+    }
+
+    /// Number of low bits that are all known to be 0
+    constexpr int trailingZeros() const {
+        return this->zeros == ~(uint64_t)0 ? 64 : __builtin_ctzll(~this->zeros);
+    }
+
+    constexpr KnownBits join(const KnownBits &rhs) const {
+        return KnownBits(this->zeros & rhs.zeros, this->ones & rhs.ones);
+    }
+
+    constexpr KnownBits meet(const KnownBits &rhs) const {
+        return KnownBits(this->zeros | rhs.zeros, this->ones | rhs.ones);
+    }
+
+    /// Whether every value matching these bits also matches `rhs`
+    constexpr bool isSubset(const KnownBits &rhs) const {
+        return (rhs.zeros & ~this->zeros) == 0 && (rhs.ones & ~this->ones) == 0;
+    }
+
+    constexpr bool operator==(const KnownBits &rhs) const {
+        return this->zeros == rhs.zeros && this->ones == rhs.ones;
+    }
+
+    constexpr bool operator!=(const KnownBits &rhs) const {
+        return !(*this == rhs);
+    }
+
+    std::string toString() const;
+
+    static constexpr uint64_t SIGN_BIT = (uint64_t)1 << 63;
+};
+
+/// Transfer functions of bitwise and arithmetic operations on known bits,
+/// computed as 64-bit word operations. Shifts, division and remainder are
+/// only precise when the right-hand side is a constant.
+namespace KnownBitsKernels {
+
+/// Mask of the lowest `n` bits
+constexpr uint64_t lowMask(int n) {
+    return n >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << n) - 1;
+}
+
+/// @brief Add two values and a carry-in bit, where `carryZero` and
+/// `carryOne` say whether the carry is known to be 0 or 1 (as in LLVM's
+/// `KnownBits::computeForAddCarry`).
+constexpr KnownBits addCarry(KnownBits lhs, KnownBits rhs, bool carryZero,
+                             bool carryOne) {
+    // The largest and smallest possible sums, from setting every unknown
+    // bit to 1 and 0 respectively
+    uint64_t maxSum = ~lhs.zeros + ~rhs.zeros + (carryZero ? 0 : 1);
+    uint64_t minSum = lhs.ones + rhs.ones + (carryOne ? 1 : 0);
+
+    // A carry into each bit is known if it is the same in both sums
+    uint64_t carryKnownZero = ~(maxSum ^ lhs.zeros ^ rhs.zeros);
+    uint64_t carryKnownOne = minSum ^ lhs.ones ^ rhs.ones;
+
+    uint64_t known = lhs.known() & rhs.known() &
+                     (carryKnownZero | carryKnownOne);
+
+    return KnownBits(~maxSum & known, minSum & known);
+}
+
+constexpr KnownBits add(KnownBits lhs, KnownBits rhs) {
+    return addCarry(lhs, rhs, true, false);
+}
+
+/// x - y = x + ~y + 1
+constexpr KnownBits sub(KnownBits lhs, KnownBits rhs) {
+    return addCarry(lhs, KnownBits(rhs.ones, rhs.zeros), false, true);
+}
+
+constexpr KnownBits mul(KnownBits lhs, KnownBits rhs) {
+    if (lhs.isConstant() && rhs.isConstant()) {
+        return KnownBits::constant(
+            (int64_t)((uint64_t)lhs.getConstant() * rhs.getConstant()));
+    }
+
+    // The low n bits of a product only depend on the low n bits of both
+    // operands
+    int lowKnown =
+        lhs.trailingKnown() < rhs.trailingKnown() ? lhs.trailingKnown()
+                                                  : rhs.trailingKnown();
+    uint64_t low = lowMask(lowKnown);
+    uint64_t product = lhs.ones * rhs.ones;
+
+    // Trailing zeros add up
+    uint64_t trailingZeros =
+        lowMask(lhs.trailingZeros() + rhs.trailingZeros());
+
+    return KnownBits((~product & low) | trailingZeros, product & low);
+}
+
+constexpr KnownBits bitAnd(KnownBits lhs, KnownBits rhs) {
+    return KnownBits(lhs.zeros | rhs.zeros, lhs.ones & rhs.ones);
+}
+
+constexpr KnownBits bitOr(KnownBits lhs, KnownBits rhs) {
+    return KnownBits(lhs.zeros & rhs.zeros, lhs.ones | rhs.ones);
+}
+
+constexpr KnownBits bitXor(KnownBits lhs, KnownBits rhs) {
+    uint64_t known = lhs.known() & rhs.known();
+    uint64_t value = lhs.ones ^ rhs.ones;
+
+    return KnownBits(~value & known, value & known);
+}
+
+/// Shift amount, if it is a known constant in [0, 64)
+constexpr int shiftAmount(KnownBits rhs) {
+    if (!rhs.isConstant() || rhs.getConstant() < 0 ||
+        rhs.getConstant() >= 64) {
+        return -1;
+    }
+
+    return (int)rhs.getConstant();
+}
+
+constexpr KnownBits shl(KnownBits lhs, KnownBits rhs) {
+    int k = shiftAmount(rhs);
+    if (k < 0) {
+        return KnownBits();
+    }
+
+    return KnownBits((lhs.zeros << k) | lowMask(k), lhs.ones << k);
+}
+
+constexpr KnownBits lshr(KnownBits lhs, KnownBits rhs) {
+    int k = shiftAmount(rhs);
+    if (k < 0) {
+        return KnownBits();
+    }
+
+    return KnownBits((lhs.zeros >> k) | ~(~(uint64_t)0 >> k), lhs.ones >> k);
+}
+
+constexpr KnownBits ashr(KnownBits lhs, KnownBits rhs) {
+    int k = shiftAmount(rhs);
+    if (k < 0) {
+        return KnownBits();
+    }
+
+    // Shifting as signed values copies the (possibly known) sign bit
+    return KnownBits((uint64_t)((int64_t)lhs.zeros >> k),
+                     (uint64_t)((int64_t)lhs.ones >> k));
+}
+
+/// Power of two that `rhs` is known to be, or 0 if it isn't one
+constexpr uint64_t powerOfTwo(KnownBits rhs) {
+    if (!rhs.isConstant() || rhs.getConstant() <= 0) {
+        return 0;
+    }
+
+    uint64_t value = rhs.ones;
+    return (value & (value - 1)) == 0 ? value : 0;
+}
+
+constexpr KnownBits udiv(KnownBits lhs, KnownBits rhs) {
+    if (lhs.isConstant() && rhs.isConstant() && rhs.getConstant() != 0) {
+        return KnownBits::constant((int64_t)(lhs.ones / rhs.ones));
+    }
+
+    uint64_t divisor = powerOfTwo(rhs);
+    if (divisor == 0) {
+        return KnownBits();
+    }
+
+    return lshr(lhs, KnownBits::constant(__builtin_ctzll(divisor)));
+}
+
+constexpr KnownBits urem(KnownBits lhs, KnownBits rhs) {
+    if (lhs.isConstant() && rhs.isConstant() && rhs.getConstant() != 0) {
+        return KnownBits::constant((int64_t)(lhs.ones % rhs.ones));
+    }
+
+    uint64_t divisor = powerOfTwo(rhs);
+    if (divisor == 0) {
+        return KnownBits();
+    }
+
+    return bitAnd(lhs, KnownBits::constant(divisor - 1));
+}
+
+/// Signed division and remainder are only folded for constants
+constexpr KnownBits div(KnownBits lhs, KnownBits rhs) {
+    if (lhs.isConstant() && rhs.isConstant() && rhs.getConstant() != 0 &&
+        !(lhs.getConstant() == INT64_MIN && rhs.getConstant() == -1)) {
+        return KnownBits::constant(lhs.getConstant() / rhs.getConstant());
+    }
+
+    return KnownBits();
+}
+
+constexpr KnownBits rem(KnownBits lhs, KnownBits rhs) {
+    if (lhs.isConstant() && rhs.isConstant() && rhs.getConstant() != 0 &&
+        !(lhs.getConstant() == INT64_MIN && rhs.getConstant() == -1)) {
+        return KnownBits::constant(lhs.getConstant() % rhs.getConstant());
+    }
+
+    return KnownBits();
+}
+
+/// @brief The bits known from a RIC - its stride fixes the low bits, and
+/// its bounds fix the high bits that every element has in common.
+constexpr KnownBits fromRIC(const RIC &ric) {
+    if (ric.isBottom() || ric.isTop()) {
+        return KnownBits();
+    }
+
+    if (RICKernels::isConstant(ric)) {
+        return KnownBits::constant(RICKernels::constantOf(ric));
+    }
+
+    // Elements are all congruent modulo the stride, so they agree on as
+    // many low bits as the stride has trailing zeros
+    uint64_t residue = RICKernels::residueOf(ric);
+    uint64_t low = lowMask(__builtin_ctzll(RICKernels::strideOf(ric)));
+    KnownBits bits(~residue & low, residue & low);
+
+    Bound lower = ric.lower(), upper = ric.upper();
+
+    if (!lower.is_infinity() && !upper.is_infinity()) {
+        // Every element shares the bits above the highest bit in which the
+        // bounds differ
+        uint64_t lo = lower.getIntNumeral(), hi = upper.getIntNumeral();
+        uint64_t diff = lo ^ hi;
+        uint64_t prefix = ~lowMask(64 - __builtin_clzll(diff));
+
+        bits = bits.meet(KnownBits(~lo & prefix, lo & prefix));
+    } else if (lower >= 0) {
+        bits = bits.meet(KnownBits(KnownBits::SIGN_BIT, 0));
+    } else if (upper < 0) {
+        bits = bits.meet(KnownBits(0, KnownBits::SIGN_BIT));
+    }
+
+    return bits;
+}
+
+/// @brief The most precise RIC containing every value matching `bits`,
+/// using the known low bits as the stride and residue.
+constexpr RIC toRIC(const KnownBits &bits) {
+    if (bits.isConflict()) {
+        return BOTTOM;
+    }
+
+    if (bits.isUnknown()) {
+        return TOP;
+    }
+
+    // RIC strides are `int`s, so only the low 30 known bits can be used
+    int lowKnown = bits.trailingKnown() < 30 ? bits.trailingKnown() : 30;
+    int64_t stride = (int64_t)1 << lowKnown;
+    int64_t residue = bits.ones & lowMask(lowKnown);
+
+    // The sentinels for infinity are the extremes of `int64_t`, so an
+    // unknown sign bit conveniently gives an infinite bound
+    return RICKernels::make(stride, residue, bits.minValue(), bits.maxValue());
+}
+
+/// Every bit known about a value, from both its RIC and its known bits
+constexpr KnownBits effective(const RIC &ric, const KnownBits &bits) {
+    return KNOWN_BITS_ENABLED ? bits.meet(fromRIC(ric)) : KnownBits();
+}
+
+/// @brief The known bits worth storing next to `ric` - unknown if the RIC
+/// already implies all of them, so that equal value sets compare equal.
+constexpr KnownBits extraBits(const RIC &ric, const KnownBits &bits) {
+    return fromRIC(ric).isSubset(bits) ? KnownBits() : bits;
+}
+
+} // namespace KnownBitsKernels
+
+/// @brief Reduce a RIC and its known bits against each other, so that
+/// each is as precise as the information in both.
+void reduce(RIC &, KnownBits &);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <static/vsa/ValueSetTable.hpp>
+
+/// @brief A bounded memo table for lattice operations on interned value
+/// sets. Since interned value sets are immutable, the result of joining,
+/// widening or narrowing two of them only depends on their IDs.
+///
+/// The table is direct-mapped: each (operation, lhs, rhs) triple hashes to
+/// exactly one slot, and a new result simply overwrites whatever was in
+/// that slot, so the table never grows past `CAPACITY` entries.
+class LatticeCache {
+  public:
+    enum Op : uint8_t { Join, Widen, Narrow, None };
+
+    static const size_t CAPACITY = 1 << 16;
+
+    static LatticeCache &getCache();
+
+    ValueSetRef join(ValueSetRef lhs, ValueSetRef rhs) {
+        return this->apply(Join, lhs, rhs);
+    }
+
+    ValueSetRef widen(ValueSetRef lhs, ValueSetRef rhs) {
+        return this->apply(Widen, lhs, rhs);
+    }
+
+    ValueSetRef narrow(ValueSetRef lhs, ValueSetRef rhs) {
+        return this->apply(Narrow, lhs, rhs);
+    }
+
+    ValueSetRef apply(Op, ValueSetRef, ValueSetRef);
+
+    size_t getHits() const { return this->hits; }
+    size_t getMisses() const { return this->misses; }
+
+  private:
+    struct Entry {
+        uint32_t lhs;
+        uint32_t rhs;
+        uint32_t result;
+        Op op = None;
+    };
+
+    LatticeCache() : entries(CAPACITY) {}
+
+    std::vector<Entry> entries;
+
+    size_t hits = 0;
+    size_t misses = 0;
+};
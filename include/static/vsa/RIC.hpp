@@ -1,23 +1,27 @@
 #pragma once
 
-#include <AE/Core/NumericValue.h>
+#include <string>
+
+#include <static/vsa/Bound.hpp>
 
 /// @brief A reduced interval congruence - represents a range with
 /// an offset and skips. If we have `RIC ric = {2, 0, 4, 1}`, then
 /// this represents the value 2 * [0, 4] + 1 = {1, 3, 5, 7, 9}.
 struct RIC {
     int stride;
-    SVF::BoundedInt start;
-    SVF::BoundedInt end;
+    Bound start;
+    Bound end;
     int offset;
 
-    RIC() : stride(1), start(SVF::BoundedInt::plus_infinity()), end(SVF::BoundedInt::minus_infinity()), offset(0) {}
-    RIC(int _offset) : stride(1), start(0), end(0), offset(_offset) {}
-    RIC(int _stride, SVF::BoundedInt _start, SVF::BoundedInt _end, int _offset)
+    constexpr RIC()
+        : stride(1), start(Bound::plus_infinity()),
+          end(Bound::minus_infinity()), offset(0) {}
+    constexpr RIC(int _offset) : stride(1), start(0), end(0), offset(_offset) {}
+    constexpr RIC(int _stride, Bound _start, Bound _end, int _offset)
         : stride(_stride), start(_start), end(_end), offset(_offset) {}
 
-    bool operator==(RIC &);
-    bool operator!=(RIC &);
+    bool operator==(const RIC &) const;
+    bool operator!=(const RIC &) const;
 
     std::string toString();
 
@@ -26,18 +30,20 @@ struct RIC {
 
     void set(const RIC &);
 
-    bool isBottom();
-    bool isTop();
+    constexpr bool isBottom() const;
+    constexpr bool isTop() const;
 
-    SVF::BoundedInt upper();
-    SVF::BoundedInt lower();
+    constexpr Bound upper() const;
+    constexpr Bound lower() const;
 
     bool isSubset(RIC &);
 
     void meetWith(RIC &);
-    void joinWith(RIC &);
-    void widenWith(RIC &);
-    void narrowWith(RIC &);
+    /// Lattice operations update this RIC in place, and return whether it
+    /// changed
+    bool joinWith(RIC &);
+    bool widenWith(RIC &);
+    bool narrowWith(RIC &);
 
     bool contains(int);
 
@@ -45,19 +51,41 @@ struct RIC {
     RIC le(RIC);
 };
 
+// Lattice operations on RICs are the innermost loop of the fixpoint, so
+// keep them small enough to be passed around by value
+static_assert(sizeof(RIC) <= 32, "RIC should fit in 32 bytes");
+
 // The "bottom" of the RIC lattice has no elements, thus
 // we define it as an impossible range that no element can satisfy
-const RIC BOTTOM = {1, SVF::BoundedInt::plus_infinity(),
-                    SVF::BoundedInt::minus_infinity(), 0};
+constexpr RIC BOTTOM = {1, Bound::plus_infinity(), Bound::minus_infinity(),
+                        0};
 
 // The "top" of the RIC lattice contains every element, thus
 // we define it as a range in which every integer is contained
-const RIC TOP = {1, SVF::BoundedInt::minus_infinity(),
-                 SVF::BoundedInt::plus_infinity(), 0};
-                 
-inline bool RIC::operator==(RIC &rhs) {
+constexpr RIC TOP = {1, Bound::minus_infinity(), Bound::plus_infinity(), 0};
+
+constexpr bool RIC::isBottom() const {
+    return this->start.is_plus_infinity() && this->end.is_minus_infinity();
+}
+
+constexpr bool RIC::isTop() const {
+    return this->start.is_minus_infinity() && this->end.is_plus_infinity() &&
+           this->stride == 1;
+}
+
+constexpr Bound RIC::lower() const {
+    return this->offset + (this->stride * this->start);
+}
+
+constexpr Bound RIC::upper() const {
+    return this->offset + (this->stride * this->end);
+}
+
+inline bool RIC::operator==(const RIC &rhs) const {
     return this->stride == rhs.stride && this->start == rhs.start &&
            this->end == rhs.end && this->offset == rhs.offset;
 }
 
-inline bool RIC::operator!=(RIC &rhs) { return !this->operator==(rhs); }
+inline bool RIC::operator!=(const RIC &rhs) const {
+    return !this->operator==(rhs);
+}
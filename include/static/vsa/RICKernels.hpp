@@ -0,0 +1,676 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+
+#include <static/vsa/RIC.hpp>
+
+/// Transfer functions of arithmetic and bitwise operations on RICs. Every
+/// kernel returns a sound overapproximation of `{x op y | x in lhs, y in
+/// rhs}`, where values are `width`-bit two's complement integers which
+/// wrap around on overflow - unsigned operations are only precise when
+/// both operands are non-negative. Infinite bounds stand for the smallest
+/// and largest `width`-bit values.
+///
+/// All kernels are `constexpr`, so they can be checked at compile time,
+/// and `tests/RICKernelsTest.cpp` checks them exhaustively at small widths.
+namespace RICKernels {
+
+/// Width of the machine words that the analysis works on
+constexpr int WORD_WIDTH = 64;
+
+constexpr bool isConstant(const RIC &ric) {
+    return ric.start == ric.end && !ric.start.is_infinity();
+}
+
+constexpr int64_t constantOf(const RIC &ric) {
+    return ric.offset + ric.stride * ric.start.getIntNumeral();
+}
+
+/// Distance between consecutive elements, where constants have a stride
+/// of 0 (so that `gcd(0, x) = x`)
+constexpr int64_t strideOf(const RIC &ric) {
+    return isConstant(ric) ? 0 : (ric.stride < 0 ? -ric.stride : ric.stride);
+}
+
+/// Any one element of the RIC, which all other elements are congruent to
+/// modulo its stride
+constexpr int64_t residueOf(const RIC &ric) {
+    return isConstant(ric) ? constantOf(ric) : ric.offset;
+}
+
+constexpr bool isNonNegative(const RIC &ric) { return ric.lower() >= 0; }
+
+/// Whether the finite `value` is an element of the RIC
+constexpr bool contains(const RIC &ric, int64_t value) {
+    if (ric.isBottom() || value < ric.lower() || value > ric.upper()) {
+        return false;
+    }
+
+    int64_t stride = strideOf(ric);
+    return stride == 0 ? value == residueOf(ric)
+                       : (value - residueOf(ric)) % stride == 0;
+}
+
+constexpr bool fitsInt(int64_t value) {
+    return value >= std::numeric_limits<int>::min() &&
+           value <= std::numeric_limits<int>::max();
+}
+
+/// Smallest `width`-bit value, which at 64 bits is -inf
+constexpr Bound minValue(int width) {
+    return width >= 64 ? Bound::minus_infinity()
+                       : Bound(-((int64_t)1 << (width - 1)));
+}
+
+/// Largest `width`-bit value, which at 64 bits is +inf
+constexpr Bound maxValue(int width) {
+    return width >= 64 ? Bound::plus_infinity()
+                       : Bound(((int64_t)1 << (width - 1)) - 1);
+}
+
+/// Whether `value` is a `width`-bit value, i.e. computing it didn't
+/// overflow. Saturated bounds mean that 64-bit arithmetic overflowed.
+constexpr bool fitsWidth(Bound value, int width) {
+    return !value.is_infinity() && value >= minValue(width) &&
+           value <= maxValue(width);
+}
+
+/// The `width`-bit value with the same low bits as `value`
+constexpr int64_t signExtend(int64_t value, int width) {
+    if (width >= 64) {
+        return value;
+    }
+
+    return (int64_t)((uint64_t)value << (64 - width)) >> (64 - width);
+}
+
+/// Largest power of 2 dividing the non-negative `value`, or 0 for 0
+constexpr int64_t powerOfTwoFactor(int64_t value) { return value & -value; }
+
+/// Magnitude of a product used in stride computations, where falling back
+/// to a stride of 1 on overflow is always sound. -2^63 has no magnitude as
+/// an `int64_t`, so it counts as overflowing too.
+constexpr int64_t strideProduct(int64_t lhs, int64_t rhs) {
+    int64_t result = 0;
+    if (__builtin_mul_overflow(lhs, rhs, &result) ||
+        result == std::numeric_limits<int64_t>::min()) {
+        return 1;
+    }
+
+    return result < 0 ? -result : result;
+}
+
+/// Mathematical modulo, which is always in [0, m)
+constexpr int64_t mod(int64_t value, int64_t m) {
+    int64_t r = value % m;
+    return r < 0 ? r + m : r;
+}
+
+/// Floor division by 2^shift
+constexpr Bound shiftRight(Bound value, int64_t shift) {
+    if (value.is_infinity()) {
+        return value;
+    }
+
+    return Bound(value.getIntNumeral() >> shift);
+}
+
+/// Whether `value` is of the form 2^k - 1, i.e. a mask of the low bits
+constexpr bool isLowMask(int64_t value) {
+    return value >= 0 && (value & (value + 1)) == 0;
+}
+
+/// Number of bits needed to represent the non-negative `value`
+constexpr int64_t bitWidth(int64_t value) {
+    int64_t width = 0;
+    while (value > 0) {
+        value >>= 1;
+        width++;
+    }
+
+    return width;
+}
+
+/// Smallest 2^k - 1 that is at least `value`
+constexpr Bound lowMaskCovering(Bound value) {
+    if (value.is_infinity() || bitWidth(value.getIntNumeral()) >= 63) {
+        return Bound::plus_infinity();
+    }
+
+    return Bound(((int64_t)1 << bitWidth(value.getIntNumeral())) - 1);
+}
+
+/// @brief Build the most precise RIC containing every value in [lo, hi]
+/// that is congruent to `residue` modulo `stride`.
+constexpr RIC make(int64_t stride, int64_t residue, Bound lo, Bound hi) {
+    // Saturated bounds mean that we've overflowed somewhere
+    if (lo.is_plus_infinity() || hi.is_minus_infinity()) {
+        return TOP;
+    }
+
+    if (hi < lo) {
+        return BOTTOM;
+    }
+
+    if (lo == hi && fitsInt(lo.getIntNumeral())) {
+        return RIC(lo.getIntNumeral());
+    }
+
+    stride = stride < 0 ? -stride : stride;
+    if (stride == 0 || stride > std::numeric_limits<int>::max()) {
+        stride = 1;
+    }
+
+    residue = mod(residue, stride);
+
+    if (!lo.is_infinity()) {
+        // The first element can only fit in an `int` if the bound does
+        if (!fitsInt(lo.getIntNumeral())) {
+            return TOP;
+        }
+
+        int64_t first =
+            lo.getIntNumeral() + mod(residue - lo.getIntNumeral(), stride);
+
+        if (first > hi) {
+            return BOTTOM;
+        }
+
+        if (!fitsInt(first)) {
+            return TOP;
+        }
+
+        Bound end = hi.is_infinity() ? hi : (hi - first) / stride;
+        return RIC(stride, 0, end, first);
+    }
+
+    if (!hi.is_infinity()) {
+        if (!fitsInt(hi.getIntNumeral())) {
+            return TOP;
+        }
+
+        int64_t last =
+            hi.getIntNumeral() - mod(hi.getIntNumeral() - residue, stride);
+
+        if (!fitsInt(last)) {
+            return TOP;
+        }
+
+        return RIC(stride, Bound::minus_infinity(), 0, last);
+    }
+
+    return RIC(stride, Bound::minus_infinity(), Bound::plus_infinity(),
+               residue);
+}
+
+constexpr RIC constant(int64_t value) { return make(0, value, value, value); }
+
+/// @brief Like `make`, for the result of arithmetic that wraps around at
+/// `width` bits. If [lo, hi] doesn't fit in `width` bits, some elements
+/// may have wrapped, which only keeps congruences modulo powers of 2, so
+/// the stride is reduced to its largest power-of-2 factor.
+///
+/// `residue` must be exact modulo 2^64, so residues computed with
+/// wrapping arithmetic are fine.
+constexpr RIC wrap(int64_t stride, int64_t residue, Bound lo, Bound hi,
+                   int width) {
+    if (fitsWidth(lo, width) && fitsWidth(hi, width)) {
+        return make(stride, residue, lo, hi);
+    }
+
+    int64_t modulus = powerOfTwoFactor(stride < 0 ? -stride : stride);
+
+    // A single value (or a stride of at least 2^width) still gives exactly
+    // one value after wrapping
+    if (modulus == 0 || (width < 64 && modulus >= ((int64_t)1 << width))) {
+        return constant(signExtend(residue, width));
+    }
+
+    return make(modulus, residue, minValue(width), maxValue(width));
+}
+
+/// Residues of sums, differences and products, which wrap around on
+/// overflow. A wrapped residue is only right modulo powers of 2, so in that
+/// case `stride` is reduced to its largest power-of-2 factor.
+constexpr int64_t addResidues(int64_t lhs, int64_t rhs, int64_t &stride) {
+    int64_t result = 0;
+    if (__builtin_add_overflow(lhs, rhs, &result)) {
+        stride = powerOfTwoFactor(stride);
+    }
+
+    return result;
+}
+
+constexpr int64_t subResidues(int64_t lhs, int64_t rhs, int64_t &stride) {
+    int64_t result = 0;
+    if (__builtin_sub_overflow(lhs, rhs, &result)) {
+        stride = powerOfTwoFactor(stride);
+    }
+
+    return result;
+}
+
+constexpr int64_t mulResidues(int64_t lhs, int64_t rhs, int64_t &stride) {
+    int64_t result = 0;
+    if (__builtin_mul_overflow(lhs, rhs, &result)) {
+        stride = powerOfTwoFactor(stride);
+    }
+
+    return result;
+}
+
+/// @brief The smallest RIC containing both operands (the RIC join).
+constexpr RIC hull(RIC lhs, RIC rhs) {
+    if (lhs.isBottom()) {
+        return rhs;
+    }
+
+    if (rhs.isBottom()) {
+        return lhs;
+    }
+
+    int64_t residueDiff = residueOf(rhs) - residueOf(lhs);
+    int64_t stride = std::gcd(std::gcd(strideOf(lhs), strideOf(rhs)),
+                              residueDiff < 0 ? -residueDiff : residueDiff);
+
+    return make(stride, residueOf(lhs), std::min(lhs.lower(), rhs.lower()),
+                std::max(lhs.upper(), rhs.upper()));
+}
+
+constexpr RIC add(RIC lhs, RIC rhs, int width = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    int64_t stride = std::gcd(strideOf(lhs), strideOf(rhs));
+    int64_t residue = addResidues(residueOf(lhs), residueOf(rhs), stride);
+
+    return wrap(stride, residue, lhs.lower() + rhs.lower(),
+                lhs.upper() + rhs.upper(), width);
+}
+
+constexpr RIC sub(RIC lhs, RIC rhs, int width = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    int64_t stride = std::gcd(strideOf(lhs), strideOf(rhs));
+    int64_t residue = subResidues(residueOf(lhs), residueOf(rhs), stride);
+
+    return wrap(stride, residue, lhs.lower() - rhs.upper(),
+                lhs.upper() - rhs.lower(), width);
+}
+
+constexpr RIC mul(RIC lhs, RIC rhs, int width = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    // Anything multiplied by 0 is 0
+    if ((isConstant(lhs) && constantOf(lhs) == 0) ||
+        (isConstant(rhs) && constantOf(rhs) == 0)) {
+        return constant(0);
+    }
+
+    // (a + s * i)(b + t * j) = ab + at * j + bs * i + st * ij
+    int64_t a = residueOf(lhs), s = strideOf(lhs);
+    int64_t b = residueOf(rhs), t = strideOf(rhs);
+    int64_t stride =
+        std::gcd(std::gcd(strideProduct(a, t), strideProduct(b, s)),
+                 strideProduct(s, t));
+
+    Bound p1 = lhs.lower() * rhs.lower();
+    Bound p2 = lhs.lower() * rhs.upper();
+    Bound p3 = lhs.upper() * rhs.lower();
+    Bound p4 = lhs.upper() * rhs.upper();
+
+    int64_t residue = mulResidues(a, b, stride);
+
+    return wrap(stride, residue, std::min(std::min(p1, p2), std::min(p3, p4)),
+                std::max(std::max(p1, p2), std::max(p3, p4)), width);
+}
+
+/// Signed division, rounding towards 0. Dividing the smallest value by -1
+/// is undefined, so division never wraps.
+constexpr RIC div(RIC lhs, RIC rhs, int = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    // Division by a range containing 0 could be anything
+    if (rhs.lower() <= 0 && rhs.upper() >= 0) {
+        return TOP;
+    }
+
+    if (isConstant(rhs)) {
+        int64_t c = constantOf(rhs);
+        Bound lo = std::min(lhs.lower() / c, lhs.upper() / c);
+        Bound hi = std::max(lhs.lower() / c, lhs.upper() / c);
+
+        // If every element is divisible by `c`, the division is exact and
+        // keeps the stride
+        int64_t s = strideOf(lhs);
+        if (s % c == 0 && residueOf(lhs) % c == 0) {
+            return make(s / c, residueOf(lhs) / c, lo, hi);
+        }
+
+        return make(1, 0, lo, hi);
+    }
+
+    // Divisor has a fixed sign, so the extremes are at the corners
+    Bound q1 = lhs.lower() / rhs.lower();
+    Bound q2 = lhs.lower() / rhs.upper();
+    Bound q3 = lhs.upper() / rhs.lower();
+    Bound q4 = lhs.upper() / rhs.upper();
+
+    return make(1, 0, std::min(std::min(q1, q2), std::min(q3, q4)),
+                std::max(std::max(q1, q2), std::max(q3, q4)));
+}
+
+constexpr RIC udiv(RIC lhs, RIC rhs, int width = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    if (!isNonNegative(lhs) || !isNonNegative(rhs)) {
+        return TOP;
+    }
+
+    return div(lhs, rhs, width);
+}
+
+/// Signed remainder, which has the sign of the dividend
+constexpr RIC rem(RIC lhs, RIC rhs, int = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    if (rhs.lower() <= 0 && rhs.upper() >= 0) {
+        return TOP;
+    }
+
+    if (isConstant(lhs) && isConstant(rhs)) {
+        return constant(constantOf(lhs) % constantOf(rhs));
+    }
+
+    // The divisor has a fixed sign, and |x % y| < |y|
+    Bound minDivisor = rhs.lower() < 0 ? -rhs.upper() : rhs.lower();
+    Bound maxDivisor = rhs.lower() < 0 ? -rhs.lower() : rhs.upper();
+
+    // Dividends which are already smaller than the divisor are unchanged
+    if (isNonNegative(lhs) && lhs.upper() < minDivisor) {
+        return lhs;
+    }
+
+    // The result has the sign of the dividend, and is no further from 0
+    Bound lo = std::max(-(maxDivisor - 1), std::min(lhs.lower(), Bound(0)));
+    Bound hi = std::min(maxDivisor - 1, std::max(lhs.upper(), Bound(0)));
+
+    // x % c = x - c * q, so x % c = x (mod gcd(stride, c))
+    int64_t stride = 1;
+    if (isConstant(rhs)) {
+        int64_t c = constantOf(rhs);
+        stride = std::gcd(strideOf(lhs), c < 0 ? -c : c);
+    }
+
+    return make(stride, residueOf(lhs), lo, hi);
+}
+
+constexpr RIC urem(RIC lhs, RIC rhs, int width = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    if (!isNonNegative(lhs) || !isNonNegative(rhs)) {
+        return TOP;
+    }
+
+    return rem(lhs, rhs, width);
+}
+
+constexpr RIC shl(RIC lhs, RIC rhs, int width = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    // Shifting by the width or more is poison. 2^63 isn't a finite bound,
+    // so shifting by 63 is left as top too.
+    if (rhs.lower() < 0 || rhs.upper() >= std::min(width, 63)) {
+        return TOP;
+    }
+
+    // x << k = x * 2^k, so join over every possible shift amount. 2^k may
+    // not fit in a RIC, so scale by it directly rather than using `mul`.
+    RIC result = BOTTOM;
+    for (int64_t k = rhs.lower().getIntNumeral();
+         k <= rhs.upper().getIntNumeral(); k++) {
+        if (!contains(rhs, k)) {
+            continue;
+        }
+
+        Bound factor = (int64_t)1 << k;
+        int64_t stride = strideProduct(strideOf(lhs), factor.getIntNumeral());
+        int64_t residue =
+            mulResidues(residueOf(lhs), factor.getIntNumeral(), stride);
+
+        result = hull(result, wrap(stride, residue, lhs.lower() * factor,
+                                   lhs.upper() * factor, width));
+    }
+
+    return result;
+}
+
+/// Arithmetic (sign-preserving) shift right, i.e. floor division by 2^k
+constexpr RIC ashr(RIC lhs, RIC rhs, int width = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    if (rhs.lower() < 0 || rhs.upper() >= std::min(width, 63)) {
+        return TOP;
+    }
+
+    RIC result = BOTTOM;
+    for (int64_t k = rhs.lower().getIntNumeral();
+         k <= rhs.upper().getIntNumeral(); k++) {
+        if (!contains(rhs, k)) {
+            continue;
+        }
+
+        Bound lo = shiftRight(lhs.lower(), k);
+        Bound hi = shiftRight(lhs.upper(), k);
+
+        // If every element is a multiple of 2^k apart, the shift is exact
+        int64_t s = strideOf(lhs);
+        RIC shifted = (s % ((int64_t)1 << k) == 0)
+                          ? make(s >> k, residueOf(lhs) >> k, lo, hi)
+                          : make(1, 0, lo, hi);
+
+        result = hull(result, shifted);
+    }
+
+    return result;
+}
+
+/// Logical shift right - only the same as `ashr` for non-negative values,
+/// as negative values shift in zeros rather than sign bits
+constexpr RIC lshr(RIC lhs, RIC rhs, int width = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    if (!isNonNegative(lhs)) {
+        return TOP;
+    }
+
+    return ashr(lhs, rhs, width);
+}
+
+constexpr RIC bitAnd(RIC lhs, RIC rhs, int = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    // Keep any constant operand on the right
+    if (isConstant(lhs) && !isConstant(rhs)) {
+        RIC tmp = lhs;
+        lhs = rhs;
+        rhs = tmp;
+    }
+
+    if (isConstant(rhs)) {
+        int64_t c = constantOf(rhs);
+
+        if (isConstant(lhs)) {
+            return constant(constantOf(lhs) & c);
+        }
+
+        if (c == 0) {
+            return constant(0);
+        }
+
+        if (c == -1) {
+            return lhs;
+        }
+
+        if (isLowMask(c)) {
+            // x & (2^k - 1) = x mod 2^k
+            int64_t stride = std::gcd(strideOf(lhs), c + 1);
+
+            if (isNonNegative(lhs) && lhs.upper() <= c) {
+                return lhs;
+            }
+
+            return make(stride, residueOf(lhs), 0, c);
+        }
+
+        if (isLowMask(~c)) {
+            // x & -2^k rounds down to a multiple of 2^k, e.g. for stack
+            // alignment
+            int64_t align = ~c + 1;
+            Bound lo = lhs.lower().is_infinity()
+                           ? lhs.lower()
+                           : Bound(lhs.lower().getIntNumeral() & c);
+            Bound hi = lhs.upper().is_infinity()
+                           ? lhs.upper()
+                           : Bound(lhs.upper().getIntNumeral() & c);
+
+            if (strideOf(lhs) % align == 0) {
+                return make(strideOf(lhs), residueOf(lhs) & c, lo, hi);
+            }
+
+            return make(align, 0, lo, hi);
+        }
+
+        if (c > 0) {
+            Bound hi = isNonNegative(lhs) ? std::min(lhs.upper(), Bound(c))
+                                          : Bound(c);
+            return make(1, 0, 0, hi);
+        }
+    }
+
+    // Masking non-negative values can only clear bits
+    if (isNonNegative(lhs) && isNonNegative(rhs)) {
+        return make(1, 0, 0, std::min(lhs.upper(), rhs.upper()));
+    }
+
+    if (isNonNegative(lhs)) {
+        return make(1, 0, 0, lhs.upper());
+    }
+
+    if (isNonNegative(rhs)) {
+        return make(1, 0, 0, rhs.upper());
+    }
+
+    return TOP;
+}
+
+constexpr RIC bitOr(RIC lhs, RIC rhs, int width = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    // Keep any constant operand on the right
+    if (isConstant(lhs) && !isConstant(rhs)) {
+        RIC tmp = lhs;
+        lhs = rhs;
+        rhs = tmp;
+    }
+
+    if (isConstant(rhs)) {
+        int64_t c = constantOf(rhs);
+
+        if (isConstant(lhs)) {
+            return constant(constantOf(lhs) | c);
+        }
+
+        if (c == 0) {
+            return lhs;
+        }
+
+        // If the low bits of every element are clear, OR-ing in a value
+        // that fits in those bits is the same as adding it
+        if (c > 0) {
+            int64_t lowBits = ((int64_t)1 << bitWidth(c)) - 1;
+            if (strideOf(lhs) % (lowBits + 1) == 0 &&
+                (residueOf(lhs) & lowBits) == 0) {
+                return add(lhs, rhs, width);
+            }
+        }
+    }
+
+    // Both sides non-negative: the result has at least the bits of the
+    // larger operand, and no bits above the widest operand
+    if (isNonNegative(lhs) && isNonNegative(rhs)) {
+        return make(1, 0, std::max(lhs.lower(), rhs.lower()),
+                    lowMaskCovering(std::max(lhs.upper(), rhs.upper())));
+    }
+
+    return TOP;
+}
+
+constexpr RIC bitXor(RIC lhs, RIC rhs, int width = WORD_WIDTH) {
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return BOTTOM;
+    }
+
+    // Keep any constant operand on the right
+    if (isConstant(lhs) && !isConstant(rhs)) {
+        RIC tmp = lhs;
+        lhs = rhs;
+        rhs = tmp;
+    }
+
+    if (isConstant(rhs)) {
+        int64_t c = constantOf(rhs);
+
+        if (isConstant(lhs)) {
+            return constant(constantOf(lhs) ^ c);
+        }
+
+        if (c == 0) {
+            return lhs;
+        }
+
+        // As with OR, XOR-ing into clear low bits is the same as adding
+        if (c > 0) {
+            int64_t lowBits = ((int64_t)1 << bitWidth(c)) - 1;
+            if (strideOf(lhs) % (lowBits + 1) == 0 &&
+                (residueOf(lhs) & lowBits) == 0) {
+                return add(lhs, rhs, width);
+            }
+        }
+    }
+
+    if (isNonNegative(lhs) && isNonNegative(rhs)) {
+        return make(1, 0, 0,
+                    lowMaskCovering(std::max(lhs.upper(), rhs.upper())));
+    }
+
+    return TOP;
+}
+
+} // namespace RICKernels
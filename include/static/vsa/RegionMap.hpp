@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <static/vsa/KnownBits.hpp>
+#include <static/vsa/RIC.hpp>
+
+/// Memory regions are numbered densely from 0 - region 0 holds globals and
+/// constants, and region 1 holds the current stack frame.
+typedef uint32_t RegionID;
+
+/// @brief A (region, offset) pair within a value set. The field names match
+/// `std::pair`, so entries can be used like the entries of a `std::map`.
+/// The known bits of the offset are kept next to its RIC, and are unknown
+/// unless set explicitly.
+struct RegionEntry {
+    RegionID first;
+    RIC second;
+    KnownBits bits;
+};
+
+/// @brief A mapping of regions to RICs, stored as a vector sorted by region.
+/// Almost every value set only refers to one or two regions, so those are
+/// stored inline, and only value sets with more regions touch the heap.
+/// Entries are trivially copyable, so copying an inline map is a `memcpy`.
+class RegionMap {
+  public:
+    typedef RegionEntry *iterator;
+    typedef const RegionEntry *const_iterator;
+
+    static const uint32_t INLINE_CAPACITY = 2;
+
+    RegionMap() {}
+    RegionMap(const RegionMap &);
+    RegionMap(RegionMap &&) noexcept;
+    ~RegionMap() { delete[] this->heap; }
+
+    RegionMap &operator=(const RegionMap &);
+    RegionMap &operator=(RegionMap &&) noexcept;
+
+    iterator begin() { return this->data(); }
+    iterator end() { return this->data() + this->count; }
+    const_iterator begin() const { return this->data(); }
+    const_iterator end() const { return this->data() + this->count; }
+
+    bool empty() const { return this->count == 0; }
+    size_t size() const { return this->count; }
+    void clear() { this->count = 0; }
+    void reserve(uint32_t);
+
+    iterator find(RegionID);
+    const_iterator find(RegionID) const;
+
+    RIC &operator[](RegionID);
+
+    std::pair<iterator, bool> insert(const RegionEntry &);
+    iterator erase(iterator);
+    iterator erase(iterator, iterator);
+
+    /// Append an entry whose region is greater than every existing region
+    void pushBack(const RegionEntry &);
+
+    bool operator==(const RegionMap &) const;
+    bool operator!=(const RegionMap &rhs) const { return !(*this == rhs); }
+
+  private:
+    RegionEntry *data() {
+        return this->heap ? this->heap : this->inlineEntries;
+    }
+    const RegionEntry *data() const {
+        return this->heap ? this->heap : this->inlineEntries;
+    }
+
+    iterator lowerBound(RegionID);
+
+    RegionEntry inlineEntries[INLINE_CAPACITY];
+    RegionEntry *heap = nullptr;
+    uint32_t count = 0;
+    uint32_t capacity = INLINE_CAPACITY;
+};
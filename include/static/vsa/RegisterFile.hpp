@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <static/vsa/StoreKernels.hpp>
+#include <static/vsa/ValueSetTable.hpp>
+
+/// The x86-64 general-purpose registers, each of which has one slot in a
+/// `RegisterFile`.
+enum class Register : uint8_t {
+    RAX,
+    RBX,
+    RCX,
+    RDX,
+    RSI,
+    RDI,
+    RBP,
+    RSP,
+    R8,
+    R9,
+    R10,
+    R11,
+    R12,
+    R13,
+    R14,
+    R15,
+    None
+};
+
+const size_t REGISTER_COUNT = (size_t)Register::None;
+
+/// @brief A register name as it appears in Remill-lifted bitcode, resolved
+/// to the slot of its full 64-bit register. Sub-registers (e.g. EAX, AX,
+/// AL and AH for RAX) are the `width` bytes of that slot starting at byte
+/// `shift`.
+struct RegisterAlias {
+    Register reg = Register::None;
+    uint8_t width = 8;
+    uint8_t shift = 0;
+
+    bool isRegister() const { return this->reg != Register::None; }
+    bool isFullWidth() const { return this->width == 8; }
+
+    /// Mask of the bits covered by this alias, before shifting
+    uint64_t mask() const {
+        return this->width == 8 ? ~(uint64_t)0
+                                : ((uint64_t)1 << (8 * this->width)) - 1;
+    }
+
+    /// Resolve a register name - `Register::None` if it isn't a GPR
+    static RegisterAlias fromName(const std::string &);
+};
+
+/// @brief The values of every general-purpose register, stored as one
+/// fixed-size column of value set handles indexed by `Register`.
+struct RegisterFile {
+    ValueSetRef values[REGISTER_COUNT];
+
+    ValueSetRef &operator[](Register reg) { return this->values[(size_t)reg]; }
+    const ValueSetRef &operator[](Register reg) const {
+        return this->values[(size_t)reg];
+    }
+
+    bool operator==(const RegisterFile &rhs) const {
+        return StoreKernels::equal(this->values, rhs.values, REGISTER_COUNT);
+    }
+
+    /// @brief Overwrite each register with `combine(lhs, rhs)`, skipping
+    /// registers whose handles are already equal.
+    /// @return Whether any register changed
+    template <typename Combine>
+    bool combineWith(const RegisterFile &rhs, Combine combine) {
+        uint64_t mask =
+            StoreKernels::diffMask(this->values, rhs.values, REGISTER_COUNT);
+        bool changed = false;
+
+        while (mask != 0) {
+            size_t i = __builtin_ctzll(mask);
+            mask &= mask - 1;
+
+            ValueSetRef result = combine(this->values[i], rhs.values[i]);
+            changed |= result != this->values[i];
+            this->values[i] = result;
+        }
+
+        return changed;
+    }
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+/// The memory resource that the nodes of persistent stores (`StoreMap` and
+/// `ALocStore`) are allocated from. By default this is the global heap - a
+/// `VSA` points it at its own pool for the duration of its analysis, so
+/// all of its stores are allocated from (and released with) that pool.
+///
+/// Nodes remember the resource they were allocated from, so a node can be
+/// freed after its scope has ended, as long as the resource is still alive.
+namespace StoreArena {
+
+std::pmr::memory_resource *current();
+
+/// @brief Allocate store nodes from `resource` for as long as this scope is
+/// alive, then go back to the previous resource.
+class Scope {
+  public:
+    explicit Scope(std::pmr::memory_resource *resource);
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    std::pmr::memory_resource *previous;
+};
+
+/// @brief Create a shared node in the current resource. Nodes that hold
+/// `pmr` containers take an allocator as their last constructor argument,
+/// so that their containers are allocated from the same resource.
+template <typename T, typename... Args>
+std::shared_ptr<T> make(Args &&...args) {
+    std::pmr::polymorphic_allocator<T> allocator(current());
+    return std::allocate_shared<T>(allocator, std::forward<Args>(args)...);
+}
+
+} // namespace StoreArena
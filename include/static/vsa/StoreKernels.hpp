@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <static/vsa/ValueSetTable.hpp>
+
+/// Bulk kernels over columns of interned value set handles. These use AVX2
+/// or SSE when the compiler targets them (see `ENABLE_NATIVE_ARCH` in
+/// CMakeLists.txt), and a portable scalar loop otherwise.
+namespace StoreKernels {
+
+/// Number of entries compared per call to `diffMask`
+const size_t CHUNK = 64;
+
+/// @brief Compare up to `CHUNK` handles at once.
+/// @return A mask with bit `i` set iff `lhs[i] != rhs[i]`, for `i < n`
+uint64_t diffMask(const ValueSetRef *lhs, const ValueSetRef *rhs, size_t n);
+
+/// @brief Whether two columns of `n` handles are identical.
+bool equal(const ValueSetRef *lhs, const ValueSetRef *rhs, size_t n);
+
+} // namespace StoreKernels
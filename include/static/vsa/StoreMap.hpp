@@ -0,0 +1,400 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include <static/vsa/StoreArena.hpp>
+#include <static/vsa/StoreKernels.hpp>
+#include <static/vsa/ValueSetTable.hpp>
+
+/// @brief A persistent mapping of keys (a-locs, registers or SVF variables)
+/// to interned value sets. Entries are kept sorted by key in fixed-size
+/// leaves, and both the leaves and the list of leaves are shared between
+/// copies, so copying a map only copies one pointer. Writing to a shared
+/// map copies the list of leaves and the one leaf being written to (path
+/// copying), leaving every other copy untouched. Leaves and the list of
+/// leaves are allocated from the current `StoreArena`.
+///
+/// Each leaf holds at most `LEAF_CAPACITY` handles in one contiguous
+/// column, so leaves can be compared with the bulk kernels in
+/// `StoreKernels.hpp` - and leaves that are still shared don't need to be
+/// compared at all.
+template <typename K> class StoreMap {
+  public:
+    static const size_t LEAF_CAPACITY = StoreKernels::CHUNK;
+
+    /// A view of one (key, value) entry, with the same field names as the
+    /// entries of a `std::map`. Entries are read-only - values are written
+    /// with `operator[]`, which unshares the leaf first.
+    struct Entry {
+        const K &first;
+        const ValueSetRef &second;
+    };
+
+    class iterator {
+      public:
+        iterator(const StoreMap *_map, size_t _leaf, size_t _index)
+            : map(_map), leaf(_leaf), index(_index) {}
+
+        Entry operator*() const {
+            const Leaf &leaf = *this->map->root->leaves[this->leaf];
+            return {(*leaf.keys)[this->index], leaf.values[this->index]};
+        }
+
+        iterator &operator++() {
+            this->index++;
+
+            if (this->index == this->map->root->leaves[this->leaf]->size()) {
+                this->leaf++;
+                this->index = 0;
+            }
+
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator prev = *this;
+            ++(*this);
+            return prev;
+        }
+
+        bool operator==(const iterator &rhs) const {
+            return this->leaf == rhs.leaf && this->index == rhs.index;
+        }
+
+        bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
+
+      private:
+        const StoreMap *map;
+        size_t leaf;
+        size_t index;
+    };
+
+    iterator begin() const { return iterator(this, 0, 0); }
+    iterator end() const { return iterator(this, this->leafCount(), 0); }
+
+    size_t size() const { return this->root ? this->root->count : 0; }
+    bool empty() const { return this->size() == 0; }
+    void clear() { this->root.reset(); }
+
+    iterator find(const K &key) const {
+        size_t leafIndex = this->findLeaf(key);
+        if (leafIndex == this->leafCount()) {
+            return this->end();
+        }
+
+        const Leaf &leaf = *this->root->leaves[leafIndex];
+        auto it = std::lower_bound(leaf.keys->begin(), leaf.keys->end(), key);
+
+        if (it == leaf.keys->end() || !(*it == key)) {
+            return this->end();
+        }
+
+        return iterator(this, leafIndex, it - leaf.keys->begin());
+    }
+
+    /// @brief Find the value of a key, inserting an empty value set if it
+    /// is not in the map yet, as with `std::map`. The leaf holding the key
+    /// is unshared, so the returned reference can be written to.
+    ValueSetRef &operator[](const K &key) {
+        auto location = this->locate(key);
+        return this->mutableLeaf(location.first).values[location.second];
+    }
+
+    std::pair<iterator, bool> insert(const std::pair<K, ValueSetRef> &entry) {
+        iterator it = this->find(entry.first);
+        if (it != this->end()) {
+            return {it, false};
+        }
+
+        auto location = this->locate(entry.first);
+        this->mutableLeaf(location.first).values[location.second] =
+            entry.second;
+
+        return {this->find(entry.first), true};
+    }
+
+    /// @brief Whether both maps hold exactly the same entries. Shared
+    /// leaves are skipped, and other leaves are compared in bulk.
+    bool operator==(const StoreMap &rhs) const {
+        if (this->root == rhs.root) {
+            return true;
+        }
+
+        if (this->size() != rhs.size()) {
+            return false;
+        }
+
+        if (!this->sameShape(rhs)) {
+            // Fall back to comparing entry by entry
+            for (auto lhsIt = this->begin(), rhsIt = rhs.begin();
+                 lhsIt != this->end(); lhsIt++, rhsIt++) {
+                if (!((*lhsIt).first == (*rhsIt).first) ||
+                    (*lhsIt).second != (*rhsIt).second) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        for (size_t i = 0; i < this->leafCount(); i++) {
+            const Leaf &lhsLeaf = *this->root->leaves[i];
+            const Leaf &rhsLeaf = *rhs.root->leaves[i];
+
+            if (&lhsLeaf != &rhsLeaf &&
+                !StoreKernels::equal(lhsLeaf.values.data(),
+                                     rhsLeaf.values.data(), lhsLeaf.size())) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /// @brief Overwrite each value in this map with `combine(lhs, rhs)`,
+    /// where `rhs` is the value under the same key in `rhs`. Values that
+    /// are already equal are skipped, so `combine` must leave a value
+    /// unchanged when combined with itself (as with join, widen and narrow).
+    /// @param addMissing whether entries only in `rhs` are copied over
+    /// @return Whether this map changed
+    template <typename Combine>
+    bool combineWith(const StoreMap &rhs, Combine combine, bool addMissing) {
+        if (this->root == rhs.root || rhs.empty()) {
+            return false;
+        }
+
+        if (this->empty()) {
+            if (addMissing) {
+                this->root = rhs.root;
+                return true;
+            }
+
+            return false;
+        }
+
+        bool changed = false;
+
+        if (this->sameShape(rhs)) {
+            // Fast path: both maps have the same layout, so compare the
+            // value columns leaf by leaf and only unshare the leaves whose
+            // values change
+            for (size_t i = 0; i < this->leafCount(); i++) {
+                const Leaf &lhsLeaf = *this->root->leaves[i];
+                const Leaf &rhsLeaf = *rhs.root->leaves[i];
+                if (&lhsLeaf == &rhsLeaf) {
+                    continue;
+                }
+
+                uint64_t mask = StoreKernels::diffMask(lhsLeaf.values.data(),
+                                                       rhsLeaf.values.data(),
+                                                       rhsLeaf.size());
+
+                ValueSetRef results[LEAF_CAPACITY];
+                uint64_t updated = 0;
+
+                while (mask != 0) {
+                    size_t j = __builtin_ctzll(mask);
+                    mask &= mask - 1;
+
+                    results[j] = combine(lhsLeaf.values[j], rhsLeaf.values[j]);
+                    if (results[j] != lhsLeaf.values[j]) {
+                        updated |= (uint64_t)1 << j;
+                    }
+                }
+
+                if (updated == 0) {
+                    continue;
+                }
+
+                changed = true;
+
+                Leaf &leaf = this->mutableLeaf(i);
+                while (updated != 0) {
+                    size_t j = __builtin_ctzll(updated);
+                    updated &= updated - 1;
+
+                    leaf.values[j] = results[j];
+                }
+            }
+
+            return changed;
+        }
+
+        for (auto kv : rhs) {
+            auto thisCandidate = this->find(kv.first);
+
+            if (thisCandidate != this->end()) {
+                ValueSetRef lhsValue = (*thisCandidate).second;
+
+                if (lhsValue != kv.second) {
+                    ValueSetRef result = combine(lhsValue, kv.second);
+
+                    if (result != lhsValue) {
+                        (*this)[kv.first] = result;
+                        changed = true;
+                    }
+                }
+            } else if (addMissing) {
+                this->insert({kv.first, kv.second});
+                changed = true;
+            }
+        }
+
+        return changed;
+    }
+
+  private:
+    typedef std::pmr::vector<K> Keys;
+
+    struct Leaf {
+        typedef std::pmr::polymorphic_allocator<std::byte> allocator_type;
+
+        explicit Leaf(const allocator_type &allocator) : values(allocator) {}
+        Leaf(const Leaf &rhs, const allocator_type &allocator)
+            : keys(rhs.keys), values(rhs.values, allocator) {}
+
+        /// Keys are shared separately from values, since most writes only
+        /// change a value
+        std::shared_ptr<const Keys> keys;
+        std::pmr::vector<ValueSetRef> values;
+
+        size_t size() const { return this->values.size(); }
+    };
+
+    struct Node {
+        typedef std::pmr::polymorphic_allocator<std::byte> allocator_type;
+
+        explicit Node(const allocator_type &allocator) : leaves(allocator) {}
+        Node(const Node &rhs, const allocator_type &allocator)
+            : leaves(rhs.leaves, allocator), count(rhs.count) {}
+
+        std::pmr::vector<std::shared_ptr<Leaf>> leaves;
+        size_t count = 0;
+    };
+
+    size_t leafCount() const {
+        return this->root ? this->root->leaves.size() : 0;
+    }
+
+    /// Whether both maps have identical keys split across identical leaves,
+    /// so that their value columns line up leaf by leaf
+    bool sameShape(const StoreMap &rhs) const {
+        if (this->leafCount() != rhs.leafCount()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < this->leafCount(); i++) {
+            const Leaf &lhsLeaf = *this->root->leaves[i];
+            const Leaf &rhsLeaf = *rhs.root->leaves[i];
+
+            if (lhsLeaf.keys != rhsLeaf.keys &&
+                *lhsLeaf.keys != *rhsLeaf.keys) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /// Index of the first leaf whose last key is not less than `key`, i.e.
+    /// the only leaf that could hold `key`
+    size_t findLeaf(const K &key) const {
+        if (!this->root) {
+            return 0;
+        }
+
+        auto &leaves = this->root->leaves;
+        auto it = std::lower_bound(
+            leaves.begin(), leaves.end(), key,
+            [](const std::shared_ptr<Leaf> &leaf, const K &key) {
+                return leaf->keys->back() < key;
+            });
+
+        return it - leaves.begin();
+    }
+
+    /// Make the list of leaves unique to this map
+    Node &mutableRoot() {
+        if (!this->root) {
+            this->root = StoreArena::make<Node>();
+        } else if (this->root.use_count() > 1) {
+            this->root = StoreArena::make<Node>(*this->root);
+        }
+
+        return *this->root;
+    }
+
+    /// Make one leaf (and the path to it) unique to this map
+    Leaf &mutableLeaf(size_t index) {
+        std::shared_ptr<Leaf> &leaf = this->mutableRoot().leaves[index];
+        if (leaf.use_count() > 1) {
+            leaf = StoreArena::make<Leaf>(*leaf);
+        }
+
+        return *leaf;
+    }
+
+    /// @brief Find the (leaf, index) position of a key, inserting it with
+    /// an empty value set if it is not in the map yet.
+    std::pair<size_t, size_t> locate(const K &key) {
+        size_t leafIndex = this->findLeaf(key);
+
+        if (leafIndex < this->leafCount()) {
+            const Leaf &leaf = *this->root->leaves[leafIndex];
+            auto it =
+                std::lower_bound(leaf.keys->begin(), leaf.keys->end(), key);
+
+            if (*it == key) {
+                return {leafIndex, it - leaf.keys->begin()};
+            }
+        } else if (leafIndex > 0) {
+            // Past the last key, so append to the last leaf
+            leafIndex--;
+        }
+
+        Node &node = this->mutableRoot();
+        if (node.leaves.empty()) {
+            auto leaf = StoreArena::make<Leaf>();
+            leaf->keys = StoreArena::make<Keys>();
+            node.leaves.push_back(leaf);
+        }
+
+        Leaf &leaf = this->mutableLeaf(leafIndex);
+        std::shared_ptr<Keys> keys = StoreArena::make<Keys>(*leaf.keys);
+
+        size_t index =
+            std::lower_bound(keys->begin(), keys->end(), key) - keys->begin();
+        keys->insert(keys->begin() + index, key);
+        leaf.values.insert(leaf.values.begin() + index, ValueSetRef());
+        node.count++;
+
+        if (keys->size() <= LEAF_CAPACITY) {
+            leaf.keys = keys;
+            return {leafIndex, index};
+        }
+
+        // Split a full leaf in half
+        size_t half = keys->size() / 2;
+        auto upper = StoreArena::make<Leaf>();
+        upper->keys = StoreArena::make<Keys>(keys->begin() + half, keys->end());
+        upper->values.assign(leaf.values.begin() + half, leaf.values.end());
+
+        keys->resize(half);
+        leaf.values.resize(half);
+        leaf.keys = keys;
+        node.leaves.insert(node.leaves.begin() + leafIndex + 1, upper);
+
+        if (index < half) {
+            return {leafIndex, index};
+        }
+
+        return {leafIndex + 1, index - half};
+    }
+
+    std::shared_ptr<Node> root;
+};
@@ -4,20 +4,29 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <map>
+#include <memory_resource>
+#include <queue>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <AE/Core/ICFGWTO.h>
 #include <Graphs/ICFG.h>
 #include <SVFIR/SVFIR.h>
 #include <Util/GeneralType.h>
 #include <static/vsa/AbstractStore.hpp>
+#include <static/vsa/Instruction.hpp>
+#include <static/vsa/StoreMap.hpp>
 #include <static/vsa/ValueSet.hpp>
+#include <static/vsa/ValueSetTable.hpp>
 
-typedef std::map<SVF::NodeID, ValueSet> SVFVarState;
+typedef StoreMap<SVF::NodeID> SVFVarState;
 
 /// @brief Data structure for the abstract state and any temporary
-/// variables stored within each basic block.
+/// variables stored within each basic block. Its maps are persistent, so
+/// snapshots are cheap to copy.
 struct Snapshot {
     // Abstract store (state of registers and a-locs)
     AbstractStore abstractStore;
@@ -32,72 +41,184 @@ struct Snapshot {
     // Size of stack
     size_t stackSize;
 
-    ValueSet getSVFVarSet(SVF::NodeID nodeID) { return this->varState[nodeID]; }
+    ValueSet getSVFVarSet(SVF::NodeID nodeID) {
+        auto it = this->varState.find(nodeID);
+        return it == this->varState.end() ? ValueSet() : (*it).second.get();
+    }
 
-    ValueSet getALocSet(ALoc aloc) {
-        return this->abstractStore.getALocSet(aloc);
+    ValueSet getALocSet(ALoc aloc, const ALocTable &table) {
+        return this->abstractStore.getALocSet(aloc, table);
     }
 
-    ValueSet getRegisterSet(std::string reg) {
+    ValueSet getRegisterSet(Register reg) {
         return this->abstractStore.getRegisterSet(reg);
     }
+};
+
+/// @brief Snapshots of basic blocks, stored contiguously and indexed by
+/// their dense block numbers, along with which blocks have a snapshot yet.
+class BlockStates {
+  public:
+    void reserve(size_t count) {
+        this->states.reserve(count);
+        this->present.reserve(count);
+    }
+
+    bool contains(BlockID id) const {
+        return id < this->present.size() && this->present[id];
+    }
+
+    /// The snapshot of a block, or `nullptr` if it doesn't have one yet
+    Snapshot *find(BlockID id) {
+        return this->contains(id) ? &this->states[id] : nullptr;
+    }
+
+    /// The snapshot of a block, which is created (empty) if it doesn't
+    /// have one yet, as with `std::map`
+    Snapshot &operator[](BlockID id) {
+        if (id >= this->states.size()) {
+            this->states.resize(id + 1);
+            this->present.resize(id + 1, false);
+        }
+
+        this->present[id] = true;
+        return this->states[id];
+    }
 
-    bool isRegister(std::string reg) {
-        return this->abstractStore.registers.find(reg) !=
-               this->abstractStore.registers.end();
+    void clear() {
+        this->states.clear();
+        this->present.clear();
     }
 
-    void initSVFVar(SVF::ValVar *);
+  private:
+    std::vector<Snapshot> states;
+    std::vector<bool> present;
 };
 
-/// @brief A class that performs value-set analysis, a slightly-
-/// adjusted version of abstract interpretation, with support for
-/// constant "skips".
-class VSA {
+/// @brief A read-only view of a contiguous list of ICFG nodes, such as the
+/// precomputed successors of a node.
+class NodeSpan {
+  public:
+    NodeSpan() : first(nullptr), last(nullptr) {}
+    NodeSpan(const SVF::ICFGNode *const *_first,
+             const SVF::ICFGNode *const *_last)
+        : first(_first), last(_last) {}
+
+    const SVF::ICFGNode *const *begin() const { return this->first; }
+    const SVF::ICFGNode *const *end() const { return this->last; }
+
+    size_t size() const { return this->last - this->first; }
+    bool empty() const { return this->first == this->last; }
+
+    const SVF::ICFGNode *operator[](size_t index) const {
+        return this->first[index];
+    }
+
+  private:
+    const SVF::ICFGNode *const *first;
+    const SVF::ICFGNode *const *last;
+};
+
+/// @brief A worklist of ICFG nodes that always pops the pending node that
+/// comes first in weak topological order, and ignores nodes that are
+/// already pending. Outside of cycles, every predecessor of a join point
+/// comes before it in WTO order, so a join point is handled once after all
+/// of its incoming paths rather than once per path.
+class WTOWorkList {
   public:
-    VSA(SVF::ICFG *_icfg) : icfg(_icfg) {
-        const int N_REGISTERS = 7;
-        std::string REGISTERS[N_REGISTERS] = {"RAX", "EAX", "RBX", "RCX",
-                                              "RDX", "RDI", "RSI"};
+    explicit WTOWorkList(const std::vector<uint32_t> &_order)
+        : order(_order) {}
+
+    bool empty() const { return this->queue.empty(); }
 
-        this->svfir = SVF::PAG::getPAG();
+    void push(const SVF::ICFGNode *node) {
+        SVF::NodeID id = node->getId();
+        if (id >= this->pending.size()) {
+            this->pending.resize(id + 1, false);
+        }
 
-        for (int i = 0; i < N_REGISTERS; i++) {
-            this->blockState.abstractStore.registers.insert(
-                {REGISTERS[i], ValueSet()});
+        if (this->pending[id]) {
+            return;
         }
+
+        this->pending[id] = true;
+        this->queue.push({this->key(id), node});
+    }
+
+    const SVF::ICFGNode *pop() {
+        const SVF::ICFGNode *node = this->queue.top().second;
+        this->queue.pop();
+        this->pending[node->getId()] = false;
+
+        return node;
+    }
+
+  private:
+    typedef std::pair<uint64_t, const SVF::ICFGNode *> Entry;
+
+    /// Position of a node in WTO order, with its ID breaking ties between
+    /// nodes that aren't in any WTO
+    uint64_t key(SVF::NodeID id) const {
+        uint64_t position = id < this->order.size() ? this->order[id]
+                                                    : UINT32_MAX;
+        return (position << 32) | id;
     }
 
+    const std::vector<uint32_t> &order;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    std::vector<bool> pending;
+};
+
+/// @brief A class that performs value-set analysis, a slightly-
+/// adjusted version of abstract interpretation, with support for
+/// constant "skips".
+class VSA {
+  public:
+    VSA(SVF::ICFG *_icfg) : icfg(_icfg) { this->svfir = SVF::PAG::getPAG(); }
+
     /// Return its abstract state given an ICFGNode
     AbstractStore &getAbsStateFromTrace(const SVF::ICFGNode *node) {
-        return this->postBasicBlock[node].abstractStore;
+        return this->postBasicBlock[this->getBlockId(node)].abstractStore;
     }
 
     void setALocs(std::vector<ALoc>);
+    /// Propagate SVF variables sparsely (see `setSVFVarSet`)
+    void setSparse(bool _sparse) { this->sparse = _sparse; }
 
     void initWTO();
+    void initNodeLayout();
+    void initVarRoles();
+    void initBlockIds();
+    BlockID getBlockId(const SVF::ICFGNode *);
     void handleGlobalNode();
     void handleMainFunction(const SVF::FunObjVar *);
+    void prepare();
+    void analyseFromMain();
     void analyse();
     std::map<SVF::NodeID, std::pair<ValueSet, size_t>> getDataAccesses();
+    std::pair<ValueSet, size_t> queryAccess(SVF::NodeID);
+    /// Number of times `handleICFGNode` has been called
+    size_t getNodeVisits() const { return this->nodeVisits; }
 
     ValueSet getSVFVarSet(SVF::NodeID, Snapshot &);
+    ValueSet getLocalSVFVarSet(SVF::NodeID, Snapshot &);
+    bool hasLocalSVFVar(SVF::NodeID, Snapshot &);
+    void setSVFVarSet(SVF::NodeID, const ValueSet &);
     std::pair<std::vector<ALoc>, std::vector<ALoc>>
     getALocsByAccessSize(ValueSet, size_t);
 
-    std::vector<const SVF::ICFGNode *>
-    getNextNodes(const SVF::ICFGNode *) const;
-    std::vector<const SVF::ICFGNode *>
-    getNextNodesOfCycle(const SVF::ICFGCycleWTO *) const;
+    NodeSpan getNextNodes(const SVF::ICFGNode *) const;
+    NodeSpan getNextNodesOfCycle(const SVF::ICFGCycleWTO *) const;
     bool mergeStatesFromPredecessors(const SVF::ICFGNode *, AbstractStore &);
 
     bool isBranchFeasible(const SVF::IntraCFGEdge *, Snapshot &);
     bool isCmpBranchFeasible(const SVF::CmpStmt *, SVF::s64_t, Snapshot &);
-    bool isStartOfBasicBlock(const SVF::ICFGNode *);
-    bool isStartOfRetBlock(const SVF::ICFGNode *);
+    bool isStartOfBasicBlock(const SVF::ICFGNode *) const;
+    bool isStartOfRetBlock(const SVF::ICFGNode *) const;
 
-    const SVF::ICFGNode *getBlockEnd(const SVF::ICFGNode *);
-    const SVF::ICFGNode *skipBlocks(const SVF::ICFGNode *, size_t);
+    const SVF::ICFGNode *getBlockEnd(const SVF::ICFGNode *) const;
+    const SVF::ICFGNode *getSuperblockEnd(const SVF::ICFGNode *) const;
+    const SVF::ICFGNode *skipBlocks(const SVF::ICFGNode *, size_t) const;
 
     void handleFunctionStart(const SVF::ICFGNode *);
     void handleFunctionEnd();
@@ -108,20 +229,30 @@ class VSA {
     void handleRemillRead(SVF::NodeID, SVF::NodeID, size_t);
     void handleRemillWrite(SVF::NodeID, SVF::NodeID, size_t);
     void handleScanf(SVF::NodeID);
-    void handleCallSite(const SVF::CallICFGNode *);
-
-    void updateAbsState(const SVF::SVFStmt *);
-    void updateStateOnAddr(const SVF::AddrStmt *);
-    void updateStateOnCmp(const SVF::CmpStmt *);
-    void updateStateOnCall(const SVF::CallPE *);
-    void updateStateOnRet(const SVF::RetPE *);
-    void updateStateOnCopy(const SVF::CopyStmt *);
-    void updateStateOnBinary(const SVF::BinaryOPStmt *);
-    void updateStateOnStore(const SVF::StoreStmt *);
-    void updateStateOnLoad(const SVF::LoadStmt *);
+    void handleCallSite(const Instruction &);
+
+    void lowerNode(const SVF::ICFGNode *);
+    void lowerStmt(const SVF::SVFStmt *);
+    Instruction lowerCall(const SVF::CallICFGNode *);
+    Operand lowerOperand(SVF::NodeID);
+    Location lowerLocation(const SVF::SVFVar *, const SVF::SVFVar *,
+                           RegisterAlias &);
+
+    void runNode(const SVF::ICFGNode *);
+    void updateAbsState(const Instruction &);
+    void updateStateOnCmp(const Instruction &);
+    void updateStateOnCopy(const Instruction &);
+    void updateStateOnBinary(const Instruction &);
+    void updateStateOnStore(const Instruction &);
+    void updateStateOnLoad(const Instruction &);
     void updateStateOnExtCall(const SVF::CallICFGNode *);
-    void updateStateOnSelect(const SVF::SelectStmt *);
-    void updateStateOnBranch(const SVF::BranchStmt *);
+    void updateStateOnSelect(const Instruction &);
+    void updateStateOnBranch(const Instruction &);
+
+    ValueSet getOperandSet(const Operand &);
+
+    ValueSet readRegister(RegisterAlias);
+    void writeRegister(RegisterAlias, ValueSet);
 
   protected:
     /// Map a function to its corresponding WTO
@@ -130,31 +261,131 @@ class VSA {
     SVF::Set<const SVF::FunObjVar *> recursiveFuns;
 
   private:
+    void findNextNodes(const SVF::ICFGNode *,
+                       std::vector<const SVF::ICFGNode *> &) const;
+    void findNextNodesOfCycle(const SVF::ICFGCycleWTO *,
+                              std::vector<const SVF::ICFGNode *> &) const;
+    bool reachesFunExit(const SVF::ICFGNode *) const;
+    void computeSlice(const SVF::ICFGNode *);
+    bool isInSlice(const SVF::ICFGNode *) const;
+    bool isSliceComplete(const SVF::FunObjVar *);
+    void recordAccess(const SVF::CallICFGNode *, ValueSet, size_t);
+
+    bool hasNodeFlag(const SVF::ICFGNode *node, uint8_t flag) const {
+        SVF::NodeID id = node->getId();
+        return id < this->nodeFlags.size() && (this->nodeFlags[id] & flag);
+    }
+
+    VarRole getVarRole(SVF::NodeID id) const {
+        return id < this->varRoles.size() ? this->varRoles[id] : VarRole();
+    }
+
     // Control-flow graph to analyse
     SVF::SVFIR *svfir;
     SVF::ICFG *icfg;
 
     // List of function cycles
     SVF::Map<const SVF::ICFGNode *, const SVF::ICFGCycleWTO *> cycleHeadToCycle;
+    /// Position of each node in the WTO of its function, indexed by node ID
+    std::vector<uint32_t> wtoOrder;
+
+    /// Flags of each node, indexed by node ID: whether its first statement
+    /// is a branch, whether it starts a basic block, whether that block
+    /// runs into the function exit, whether it is inside a cycle, and
+    /// whether its successor is in the same superblock
+    std::vector<uint8_t> nodeFlags;
+    static const uint8_t ENDS_BLOCK = 1;
+    static const uint8_t STARTS_BLOCK = 2;
+    static const uint8_t STARTS_RET_BLOCK = 4;
+    static const uint8_t IN_CYCLE = 8;
+    static const uint8_t CONTINUES_SUPERBLOCK = 16;
+
+    /// Successors of every node (see `getNextNodes`), stored back to back
+    /// in node ID order
+    std::vector<const SVF::ICFGNode *> successors;
+    /// Index in `successors` of the first successor of each node, indexed
+    /// by node ID, followed by the total number of successors
+    std::vector<uint32_t> successorStart;
+    /// Last node of the superblock holding each node, indexed by node ID
+    /// (`nullptr` for nodes that are a superblock on their own)
+    std::vector<const SVF::ICFGNode *> superblockEnds;
+    /// Nodes outside of each cycle that it can exit to
+    SVF::Map<const SVF::ICFGCycleWTO *, std::vector<const SVF::ICFGNode *>>
+        cycleExits;
 
     /// Program counter (and related variables), treated as constants
     SVF::s64_t pc;
     SVF::s64_t nextPc;
     SVF::s64_t returnPc;
 
+    /// Pool that every store of this analysis is allocated from (see
+    /// `StoreArena`). It is declared before any store, so that it outlives
+    /// them, and is released in one go when the analysis is destroyed.
+    std::pmr::unsynchronized_pool_resource arena;
+
+    /// Dense IDs of the a-locs in this analysis, which every store of the
+    /// analysis is indexed by
+    ALocTable alocTable;
+
     /// Global variables extracted from global node
     SVFVarState globalState;
 
+    /// Whether `prepare` has run yet
+    bool prepared = false;
+    /// State right after the global node, which every analysis from `main`
+    /// starts from
+    Snapshot initialState;
+
+    /// Whether only the slice of the current query is analysed
+    bool slicing = false;
+    /// Nodes in the slice of the current query, indexed by node ID
+    std::vector<bool> slice;
+    /// Functions with at least one node in the slice of the current query
+    SVF::Set<const SVF::FunObjVar *> sliceFuns;
+    /// Functions outside the slice of the current query, and whether every
+    /// call to them is in the slice (see `isSliceComplete`)
+    SVF::Map<const SVF::FunObjVar *, bool> completeFuns;
+
+    /// Whether SVF variables are propagated sparsely, along their def-use
+    /// edges, rather than through the snapshot of every block
+    bool sparse = false;
+    /// In sparse mode, the value of every SVF variable, indexed by node ID
+    std::vector<ValueSetRef> sparseVars;
+    /// In sparse mode, which SVF variables have been given a value yet
+    std::vector<bool> sparseDefined;
+
+    /// Role of every SVF variable, indexed by ID (see `initVarRoles`)
+    std::vector<VarRole> varRoles;
+
+    /// Instructions decoded from the statements of every ICFG node run so
+    /// far, with each node's instructions stored contiguously
+    std::vector<Instruction> instructions;
+    /// Range of `instructions` decoded from each node, indexed by node ID
+    /// (`NOT_LOWERED` for nodes that haven't been decoded yet)
+    std::vector<std::pair<uint32_t, uint32_t>> nodeInstructions;
+    static const uint32_t NOT_LOWERED = UINT32_MAX;
+
     /// Mapping of variables (alocs, registers, SVF vars) to value sets,
     /// for the current basic block
     Snapshot blockState;
 
+    /// Dense block number of each ICFG node that starts or ends a basic
+    /// block, indexed by node ID (`NO_BLOCK` for every other node)
+    std::vector<BlockID> blockIds;
+    /// Number of block numbers handed out so far
+    BlockID blockCount = 0;
+    static const BlockID NO_BLOCK = UINT32_MAX;
+
     /// State of variables immediately before the start of a basic block
-    std::map<const SVF::ICFGNode *, Snapshot> preBasicBlock;
+    BlockStates preBasicBlock;
     /// State of variables immediately after the end of a basic block
-    std::map<const SVF::ICFGNode *, Snapshot> postBasicBlock;
+    BlockStates postBasicBlock;
+    /// Number of times `handleICFGNode` has been called
+    size_t nodeVisits = 0;
     /// Data accesses
     bool isInCycle;
     bool narrowing;
     std::map<SVF::NodeID, std::pair<ValueSet, size_t>> dataAccesses;
+    /// Accesses that `queryAccess` found are never reached
+    SVF::Set<SVF::NodeID> unreachedAccesses;
 };
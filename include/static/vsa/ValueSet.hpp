@@ -1,16 +1,25 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <map>
 #include <static/vsa/RIC.hpp>
+#include <static/vsa/RegionMap.hpp>
 
 /// @brief A representation of all addresses that an a-loc
 /// could hold. It is represented as a mapping of memory regions
 /// (represented as uints) to *offsets* from the start of that
 /// region.
 struct ValueSet {
-    bool top;
-    std::map<uint64_t, RIC> values;
+    bool top = false;
+    RegionMap values;
+
+    /// @brief Maximum number of regions a value set can refer to - a join
+    /// that would go past this widens the value set to top instead, which
+    /// bounds the cost of every later operation on it. 0 means no limit.
+    static uint32_t regionLimit;
+
+    /// Number of joins that have gone past `regionLimit`
+    static size_t regionLimitHits;
 
     ValueSet() {}
     ValueSet(int c) { this->values.insert({0, RIC(c)}); }
@@ -26,9 +35,12 @@ struct ValueSet {
     bool isSubset(ValueSet &);
 
     void meetWith(ValueSet &);
-    void joinWith(ValueSet);
-    void widenWith(ValueSet &);
-    void narrowWith(ValueSet &);
+
+    /// Join, widen and narrow update this value set in place, and return
+    /// whether it changed
+    bool joinWith(ValueSet);
+    bool widenWith(ValueSet &);
+    bool narrowWith(ValueSet &);
 
     void adjust(int);
 
@@ -37,7 +49,10 @@ struct ValueSet {
 
     std::string toString();
 
-    RIC getGlobal() { return this->values[0]; }
+    RIC getGlobal() {
+        auto global = this->values.find(0);
+        return global == this->values.end() ? RIC() : global->second;
+    }
 
     int getConstant() { return getGlobal().getConstant(); }
 };
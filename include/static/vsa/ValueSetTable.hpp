@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include <static/vsa/ValueSet.hpp>
+
+/// @brief Hashes the full contents of a value set, i.e. its `top` flag and
+/// every region and RIC.
+struct ValueSetHash {
+    size_t operator()(const ValueSet &) const;
+};
+
+/// @brief Structural equality of two value sets - unlike
+/// `ValueSet::operator==`, both sides must have exactly the same regions.
+struct ValueSetEqual {
+    bool operator()(const ValueSet &, const ValueSet &) const;
+};
+
+/// @brief A global table of canonical value sets. Each distinct value set
+/// is stored exactly once, and is referred to by a 32-bit ID.
+class ValueSetTable {
+  public:
+    /// ID of the default (empty) value set
+    static const uint32_t EMPTY = 0;
+
+    static ValueSetTable &getTable();
+
+    uint32_t intern(const ValueSet &);
+    const ValueSet &lookup(uint32_t id) const { return this->values[id]; }
+
+    size_t size() const { return this->values.size(); }
+
+  private:
+    ValueSetTable() { this->intern(ValueSet()); }
+
+    // `std::deque` never moves its elements, so references returned by
+    // `lookup` stay valid as the table grows
+    std::deque<ValueSet> values;
+    // IDs of all value sets with a given hash - each value set is only
+    // stored once, in `values`
+    std::unordered_map<size_t, std::vector<uint32_t>> buckets;
+};
+
+/// @brief A handle to an interned value set. Copying a handle is copying a
+/// single integer, and two handles are equal iff their value sets are
+/// structurally equal.
+class ValueSetRef {
+  public:
+    ValueSetRef() : id(ValueSetTable::EMPTY) {}
+    ValueSetRef(const ValueSet &vs)
+        : id(ValueSetTable::getTable().intern(vs)) {}
+
+    const ValueSet &get() const {
+        return ValueSetTable::getTable().lookup(this->id);
+    }
+
+    operator const ValueSet &() const { return this->get(); }
+
+    uint32_t getId() const { return this->id; }
+
+    /// Rebuild a handle from an ID previously returned by `getId`
+    static ValueSetRef fromId(uint32_t id) {
+        ValueSetRef ref;
+        ref.id = id;
+        return ref;
+    }
+
+    bool operator==(const ValueSetRef &rhs) const { return this->id == rhs.id; }
+    bool operator!=(const ValueSetRef &rhs) const { return this->id != rhs.id; }
+
+  private:
+    uint32_t id;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <static/vsa/RegisterFile.hpp>
+
+/// What a load or store refers to, resolved from the role of its pointer
+enum class Location : uint8_t {
+    /// Anything that isn't tracked
+    Other,
+    PC,
+    NextPC,
+    ReturnPC,
+    /// `RBP`, which is treated as the base of the current stack frame
+    FrameBase,
+    /// A general-purpose register, given by the instruction's `alias`
+    Register
+};
+
+/// @brief What an SVF variable refers to when it is used as the pointer of
+/// a load or store - one of Remill's state variables, or `Location::Other`
+/// for anything else.
+struct VarRole {
+    Location location = Location::Other;
+    /// Register (or part of one) for `Register` and `FrameBase`. A width
+    /// of 0 is a pointer into a register's slot, which is as wide as each
+    /// load or store through it (see `resolve`).
+    RegisterAlias alias;
+
+    bool operator==(const VarRole &rhs) const {
+        return this->location == rhs.location &&
+               this->alias.reg == rhs.alias.reg &&
+               this->alias.width == rhs.alias.width &&
+               this->alias.shift == rhs.alias.shift;
+    }
+
+    bool operator!=(const VarRole &rhs) const { return !(*this == rhs); }
+
+    VarRole resolve(uint32_t) const;
+    bool agreesWith(const VarRole &) const;
+
+    /// Classify a variable by the name Remill gives it
+    static VarRole fromName(const std::string &);
+    /// Classify a GEP into `%struct.State` by its constant indices
+    static VarRole fromStatePath(const std::vector<int64_t> &);
+};
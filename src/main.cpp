@@ -1,4 +1,6 @@
 #include <iostream>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include "Graphs/SVFG.h"
@@ -7,8 +9,43 @@
 #include "WPA/Andersen.h"
 
 #include <static/asi/ASI.hpp>
+#include <static/vsa/LatticeCache.hpp>
 #include <static/vsa/VSA.hpp>
 
+static const Option<SVF::u32_t>
+    MaxRegions("vsa-max-regions",
+               "Maximum number of memory regions in a value set before it is "
+               "widened to top (0 for no limit)",
+               0);
+
+static const Option<bool>
+    SparseVSA("vsa-sparse",
+              "Propagate SVF variables along their def-use edges, rather than "
+              "through the state of every basic block",
+              false);
+
+static const Option<std::string> QueryAccesses(
+    "vsa-query",
+    "Comma-separated IDs of the call nodes of data accesses to find on "
+    "demand, only analysing what can run before each one (instead of the "
+    "whole program)",
+    "");
+
+/// Parse the node IDs given to `-vsa-query`
+static std::vector<SVF::NodeID> parseQueries(const std::string &list) {
+    std::vector<SVF::NodeID> ids;
+    std::stringstream stream(list);
+    std::string id;
+
+    while (std::getline(stream, id, ',')) {
+        if (!id.empty()) {
+            ids.push_back(std::stoul(id));
+        }
+    }
+
+    return ids;
+}
+
 std::map<ALoc, ASIType *> reconstructTypes(SVF::ICFG *icfg) {
     // Return types...
     /// VSA analysis
@@ -16,10 +53,35 @@ std::map<ALoc, ASIType *> reconstructTypes(SVF::ICFG *icfg) {
                                ALoc{1, 40, 8}};
 
     VSA vsa(icfg);
+    vsa.setSparse(SparseVSA());
     vsa.setALocs(alocs);
-    vsa.analyse();
 
-    auto accesses = vsa.getDataAccesses();
+    std::map<SVF::NodeID, std::pair<ValueSet, size_t>> accesses;
+    std::vector<SVF::NodeID> queries = parseQueries(QueryAccesses());
+
+    if (queries.empty()) {
+        vsa.analyse();
+        accesses = vsa.getDataAccesses();
+    } else {
+        for (SVF::NodeID id : queries) {
+            auto access = vsa.queryAccess(id);
+            if (access.second == 0) {
+                std::cout << "Data access at node " << id
+                          << " is never reached" << std::endl;
+                continue;
+            }
+
+            accesses[id] = access;
+        }
+    }
+
+    LatticeCache &cache = LatticeCache::getCache();
+    std::cout << "Lattice cache: " << cache.getHits() << " hits, "
+              << cache.getMisses() << " misses" << std::endl;
+    std::cout << "Region limit: " << ValueSet::regionLimitHits
+              << " joins widened to top" << std::endl;
+    std::cout << "Node visits: " << vsa.getNodeVisits()
+              << " calls to handleICFGNode" << std::endl;
 
     for (auto kv : accesses) {
         std::cout << "Data access at node " << kv.first << ": "
@@ -40,6 +102,8 @@ int main(int argc, char *argv[]) {
         OptionBase::parseOptions(argc, argv, "Whole Program Points-to Analysis",
                                  "[options] <input-bitcode...>");
 
+    ValueSet::regionLimit = MaxRegions();
+
     if (SVF::Options::WriteAnder() == "ir_annotator") {
         SVF::LLVMModuleSet::preProcessBCs(moduleNameVec);
     }
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <deque>
 #include <numeric>
 #include <static/asi/ASI.hpp>
 
@@ -7,25 +8,10 @@
 std::map<uint64_t, std::vector<ALoc>> ASI::findALocs(ValueSet address) {
     std::map<uint64_t, std::vector<ALoc>> referenced;
 
-    for (ALoc aloc : this->alocs) {
-        uint64_t region = aloc.region;
-        auto addrOfRegion = address.values.find(region);
-
-        if (addrOfRegion == address.values.end()) {
-            continue;
-        }
-
-        RIC ric = (*addrOfRegion).second;
-
-        bool ricLowerInAloc = ric.lower() >= aloc.offset &&
-                              ric.lower() < (aloc.offset + aloc.size);
-        bool ricSurroundsAloc = ric.lower() < aloc.offset &&
-                                ric.upper() >= (aloc.offset + aloc.size);
-        bool ricUpperInAloc = ric.upper() >= aloc.offset &&
-                              ric.upper() < (aloc.offset + aloc.size);
-
-        if (ricLowerInAloc || ricSurroundsAloc || ricUpperInAloc) {
-            referenced[region].push_back(aloc);
+    for (auto entry : address.values) {
+        const ALocIndex &index = this->table.getIndex();
+        for (ALocID id : index.overlapping(entry.first, entry.second)) {
+            referenced[entry.first].push_back(this->table.lookup(id));
         }
     }
 
@@ -227,7 +213,7 @@ ArrayType *ASI::unifyArrays(ArrayType *lhs, ArrayType *rhs) {
 /// has the remainder.
 /// @param type an integer or array type
 /// @param n the number of bytes to take for first type
-/// @return 
+/// @return
 std::pair<ASIType *, ASIType *> ASI::split(ASIType *type, size_t n) {
     if (IntType *intType = dynamic_cast<IntType *>(type)) {
         IntType *target = new IntType(n);
@@ -242,17 +228,20 @@ std::pair<ASIType *, ASIType *> ASI::split(ASIType *type, size_t n) {
     int index = n / arrayType->getChild()->getSize();
     if (index == 1) {
         ASIType *target = arrayType->getChild();
-        ArrayType *remainder = new ArrayType(arrayType->getChild(), arrayType->getSize() - 1);
+        ArrayType *remainder =
+            new ArrayType(arrayType->getChild(), arrayType->getSize() - 1);
 
         return {target, remainder};
     } else if (index == arrayType->getSize() - 1) {
-        ArrayType *target = new ArrayType(arrayType->getChild(), arrayType->getSize() - 1);
+        ArrayType *target =
+            new ArrayType(arrayType->getChild(), arrayType->getSize() - 1);
         ASIType *remainder = arrayType->getChild();
 
         return {target, remainder};
     } else {
         ArrayType *target = new ArrayType(arrayType->getChild(), index);
-        ArrayType *remainder = new ArrayType(arrayType->getChild(), arrayType->getSize() - index);
+        ArrayType *remainder =
+            new ArrayType(arrayType->getChild(), arrayType->getSize() - index);
 
         return {target, remainder};
     }
@@ -277,18 +266,21 @@ StructType *ASI::unifyStructs(StructType *lhs, StructType *rhs) {
         rhsDeque.pop_front();
 
         if (leftChild->getSize() == rightChild->getSize()) {
-            // Both children are of equal size, just unify them and add to result
+            // Both children are of equal size, just unify them and add to
+            // result
             ASIType *unified = unify(leftChild, rightChild);
             result->addChild(unified);
         } else if (leftChild->getSize() > rightChild->getSize()) {
-            // Split left child, unify whatever is equal and add remainder back to lhsDeque
+            // Split left child, unify whatever is equal and add remainder
+            // back to lhsDeque
             auto splitLeft = split(leftChild, rightChild->getSize());
             lhsDeque.push_front(splitLeft.second);
 
             ASIType *unified = unify(splitLeft.first, rightChild);
             result->addChild(unified);
         } else {
-            // Split right child, unify whatever is equal and add remainder back to rhsDeque
+            // Split right child, unify whatever is equal and add remainder
+            // back to rhsDeque
             auto splitRight = split(rightChild, leftChild->getSize());
             rhsDeque.push_front(splitRight.second);
 
@@ -0,0 +1,57 @@
+#include <functional>
+#include <static/vsa/ALoc.hpp>
+
+bool ALoc::operator<(const ALoc &rhs) const {
+    if (this->region < rhs.region) {
+        return true;
+    }
+
+    if (this->region > rhs.region) {
+        return false;
+    }
+
+    if (this->offset < rhs.offset) {
+        return true;
+    }
+
+    if (this->offset > rhs.offset) {
+        return false;
+    }
+
+    if (this->size < rhs.size) {
+        return true;
+    }
+
+    if (this->size > rhs.size) {
+        return false;
+    }
+
+    return false;
+}
+
+bool ALoc::operator==(const ALoc &rhs) const {
+    return this->region == rhs.region && this->offset == rhs.offset &&
+           this->size == rhs.size;
+}
+
+bool ALoc::in(RIC ric) {
+    int alocUpper = this->offset + this->size;
+
+    return (ric.lower() >= this->offset && ric.lower() < alocUpper) ||
+           (ric.upper() >= this->offset && ric.upper() < alocUpper);
+}
+
+std::string ALoc::toString() {
+    return "mem" + std::to_string(this->region) + "_" +
+           std::to_string(this->offset) + "_" + std::to_string(this->size);
+}
+
+size_t ALocHash::operator()(const ALoc &aloc) const {
+    size_t seed = std::hash<uint64_t>()(aloc.region);
+    seed ^= std::hash<int64_t>()(aloc.offset) + 0x9e3779b97f4a7c15ULL +
+            (seed << 6) + (seed >> 2);
+    seed ^= std::hash<uint64_t>()(aloc.size) + 0x9e3779b97f4a7c15ULL +
+            (seed << 6) + (seed >> 2);
+
+    return seed;
+}
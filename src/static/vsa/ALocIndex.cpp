@@ -0,0 +1,55 @@
+#include <algorithm>
+
+#include <static/vsa/ALocIndex.hpp>
+
+void ALocIndex::insert(ALocID id, const ALoc &aloc) {
+    Region &region = this->regions[aloc.region];
+
+    Entry entry{aloc.offset, aloc.offset + (int64_t)aloc.size, id};
+    auto it = std::lower_bound(
+        region.entries.begin(), region.entries.end(), entry,
+        [](const Entry &lhs, const Entry &rhs) {
+            return lhs.offset < rhs.offset ||
+                   (lhs.offset == rhs.offset && lhs.end < rhs.end) ||
+                   (lhs.offset == rhs.offset && lhs.end == rhs.end &&
+                    lhs.id < rhs.id);
+        });
+
+    if (it != region.entries.end() && it->id == id) {
+        return;
+    }
+
+    region.entries.insert(it, entry);
+    region.maxSize = std::max(region.maxSize, entry.end - entry.offset);
+    this->count++;
+}
+
+std::vector<ALocID> ALocIndex::overlapping(RegionID regionId,
+                                           const RIC &ric) const {
+    std::vector<ALocID> found;
+
+    auto regionIt = this->regions.find(regionId);
+    if (regionIt == this->regions.end() || ric.isBottom()) {
+        return found;
+    }
+
+    const Region &region = regionIt->second;
+    Bound lower = ric.lower();
+    Bound upper = ric.upper();
+
+    // No a-loc starting at or before `lower - maxSize` can reach `lower`.
+    // Bounds saturate, so an infinite lower bound starts at the first a-loc
+    Bound first = lower - Bound(region.maxSize);
+    auto it = std::upper_bound(region.entries.begin(), region.entries.end(),
+                               first, [](Bound offset, const Entry &entry) {
+                                   return offset < Bound(entry.offset);
+                               });
+
+    for (; it != region.entries.end() && Bound(it->offset) <= upper; it++) {
+        if (Bound(it->end) > lower) {
+            found.push_back(it->id);
+        }
+    }
+
+    return found;
+}
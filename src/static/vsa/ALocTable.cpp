@@ -0,0 +1,17 @@
+#include <static/vsa/ALocTable.hpp>
+
+/// @brief Find the dense ID of an a-loc, giving it the next free ID if it
+/// has not been seen before.
+ALocID ALocTable::intern(const ALoc &aloc) {
+    auto it = this->ids.find(aloc);
+    if (it != this->ids.end()) {
+        return it->second;
+    }
+
+    ALocID id = this->alocs.size();
+    this->alocs.push_back(aloc);
+    this->ids[aloc] = id;
+    this->index.insert(id, aloc);
+
+    return id;
+}
@@ -1,132 +1,37 @@
 #include <static/vsa/AbstractStore.hpp>
-
-bool ALoc::operator<(const ALoc &rhs) const {
-    if (this->region < rhs.region) {
-        return true;
-    }
-
-    if (this->region > rhs.region) {
-        return false;
-    }
-
-    if (this->offset < rhs.offset) {
-        return true;
-    }
-
-    if (this->offset > rhs.offset) {
-        return false;
-    }
-
-    if (this->size < rhs.size) {
-        return true;
-    }
-
-    if (this->size > rhs.size) {
-        return false;
-    }
-
-    return false;
-}
-
-bool ALoc::in(RIC ric) {
-    int alocUpper = this->offset + this->size;
-
-    return (ric.lower() >= this->offset && ric.lower() < alocUpper) ||
-           (ric.upper() >= this->offset && ric.upper() < alocUpper);
-}
-
-std::string ALoc::toString() {
-    return "mem" + std::to_string(this->region) + "_" +
-           std::to_string(this->offset) + "_" + std::to_string(this->size);
+#include <static/vsa/LatticeCache.hpp>
+
+/// @brief Combine every a-loc and register of `lhs` with the same one in
+/// `rhs`, using one of the lattice operations in `LatticeCache`.
+/// @param addMissing whether a-locs only in `rhs` are copied into `lhs`
+/// @return Whether `lhs` changed
+static bool combineWith(AbstractStore &lhs, const AbstractStore &rhs,
+                        LatticeCache::Op op, bool addMissing) {
+    LatticeCache &cache = LatticeCache::getCache();
+    auto combine = [&](ValueSetRef lhsValue, ValueSetRef rhsValue) {
+        return cache.apply(op, lhsValue, rhsValue);
+    };
+
+    bool alocsChanged = lhs.alocs.combineWith(rhs.alocs, combine, addMissing);
+    bool registersChanged = lhs.registers.combineWith(rhs.registers, combine);
+
+    return alocsChanged || registersChanged;
 }
 
 bool AbstractStore::operator==(AbstractStore &rhs) {
-    // Iterate over a-loc mapping
-    for (auto kv : this->alocs) {
-        ALoc aloc = kv.first;
-        auto rhsKv = rhs.alocs.find(aloc);
-
-        if (rhsKv == rhs.alocs.end()) {
-            return false;
-        }
-
-        if (kv.second != (*rhsKv).second) {
-            return false;
-        }
-    }
-
-    // Iterate over register mapping
-    for (auto kv : this->registers) {
-        auto rhsKv = rhs.registers.find(kv.first);
-
-        if (rhsKv == rhs.registers.end()) {
-            return false;
-        }
-
-        if (kv.second != (*rhsKv).second) {
-            return false;
-        }
-    }
-
-    return true;
+    // Shared chunks are skipped, and value sets are interned, so the
+    // remaining entries are compared by their handles
+    return this->alocs == rhs.alocs && this->registers == rhs.registers;
 }
 
-void AbstractStore::joinWith(AbstractStore &rhs) {
-    for (auto kv : rhs.alocs) {
-        auto aloc = kv.first;
-        auto thisCandidate = this->alocs.find(aloc);
-
-        if (thisCandidate != this->alocs.end()) {
-            (*thisCandidate).second.joinWith(kv.second);
-        } else {
-            this->alocs.insert({aloc, kv.second});
-        }
-    }
-
-    for (auto kv : rhs.registers) {
-        auto reg = kv.first;
-        auto thisCandidate = this->registers.find(reg);
-
-        if (thisCandidate != this->registers.end()) {
-            (*thisCandidate).second.joinWith(kv.second);
-        } else {
-            this->registers.insert({reg, kv.second});
-        }
-    }
+bool AbstractStore::joinWith(AbstractStore &rhs) {
+    return combineWith(*this, rhs, LatticeCache::Join, true);
 }
 
-void AbstractStore::widenWith(AbstractStore &rhs) {
-    for (auto kv = this->alocs.begin(); kv != this->alocs.end(); kv++) {
-        auto aloc = (*kv).first;
-        auto rhsCandidate = rhs.alocs.find(aloc);
-
-        if (rhsCandidate != rhs.alocs.end()) {
-            (*kv).second.widenWith((*rhsCandidate).second);
-        }
-    }
-
-    for (auto kv : this->registers) {
-        auto reg = kv.first;
-        this->registers[reg].widenWith(rhs.registers[reg]);
-    }
+bool AbstractStore::widenWith(AbstractStore &rhs) {
+    return combineWith(*this, rhs, LatticeCache::Widen, false);
 }
 
-void AbstractStore::narrowWith(AbstractStore &rhs) {
-    for (auto kv = this->alocs.begin(); kv != this->alocs.end(); kv++) {
-        auto aloc = (*kv).first;
-        auto rhsCandidate = rhs.alocs.find(aloc);
-
-        if (rhsCandidate != rhs.alocs.end()) {
-            (*kv).second.narrowWith((*rhsCandidate).second);
-        }
-    }
-
-    for (auto kv : this->registers) {
-        auto reg = kv.first;
-        auto rhsCandidate = rhs.registers.find(reg);
-
-        if (rhsCandidate != rhs.registers.end()) {
-            kv.second.narrowWith((*rhsCandidate).second);
-        }
-    }
+bool AbstractStore::narrowWith(AbstractStore &rhs) {
+    return combineWith(*this, rhs, LatticeCache::Narrow, false);
 }
@@ -0,0 +1,49 @@
+#include <static/vsa/Intrinsics.hpp>
+
+IntrinsicTable &IntrinsicTable::getTable() {
+    static IntrinsicTable table;
+    return table;
+}
+
+/// @brief Register the intrinsics that Remill-lifted binaries call. Reads
+/// and writes of floats have the same shape as integer reads and writes,
+/// so they are handled as accesses of the same size. The 80- and 128-bit
+/// float accesses pass their value through a pointer instead, so they are
+/// left as external calls.
+IntrinsicTable::IntrinsicTable() {
+    const struct {
+        const char *suffix;
+        uint8_t size;
+    } ACCESSES[] = {{"8", 1},  {"16", 2},  {"32", 4},
+                    {"64", 8}, {"f32", 4}, {"f64", 8}};
+
+    for (const auto &access : ACCESSES) {
+        this->add(std::string("__remill_read_memory_") + access.suffix,
+                  {CallKind::MemoryRead, access.size});
+        this->add(std::string("__remill_write_memory_") + access.suffix,
+                  {CallKind::MemoryWrite, access.size});
+    }
+
+    this->add("EXTERNAL.__isoc99_scanf", {CallKind::Scanf, 8});
+
+    const char *IGNORED[] = {
+        "__remill_function_call",
+        "__remill_barrier_load_load",
+        "__remill_barrier_load_store",
+        "__remill_barrier_store_load",
+        "__remill_barrier_store_store",
+        "__remill_atomic_begin",
+        "__remill_atomic_end",
+        "__remill_delay_slot_begin",
+        "__remill_delay_slot_end",
+    };
+
+    for (const char *name : IGNORED) {
+        this->add(name, {CallKind::Ignored, 0});
+    }
+}
+
+const Intrinsic *IntrinsicTable::lookup(const std::string &name) const {
+    auto it = this->intrinsics.find(name);
+    return it == this->intrinsics.end() ? nullptr : &it->second;
+}
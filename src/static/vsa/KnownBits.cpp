@@ -0,0 +1,44 @@
+#include <static/vsa/KnownBits.hpp>
+
+std::string KnownBits::toString() const {
+    // One character per bit from the top, skipping the unknown high bits
+    std::string bits;
+    for (int i = 63; i >= 0; i--) {
+        uint64_t bit = (uint64_t)1 << i;
+
+        if (this->zeros & bit) {
+            bits += '0';
+        } else if (this->ones & bit) {
+            bits += '1';
+        } else if (!bits.empty()) {
+            bits += '?';
+        }
+    }
+
+    return bits.empty() ? "?" : "..." + bits;
+}
+
+void reduce(RIC &ric, KnownBits &bits) {
+    if (!KNOWN_BITS_ENABLED || ric.isBottom()) {
+        return;
+    }
+
+    // RIC arithmetic saturates where 64-bit arithmetic wraps around, so the
+    // two domains can disagree after an overflow - trust the RIC then
+    KnownBits combined = bits.meet(KnownBitsKernels::fromRIC(ric));
+    RIC reduced = ric;
+
+    if (!combined.isConflict()) {
+        RIC fromBits = KnownBitsKernels::toRIC(combined);
+        reduced.meetWith(fromBits);
+    }
+
+    if (combined.isConflict() || reduced.isBottom()) {
+        bits = KnownBits();
+        return;
+    }
+
+    ric = reduced;
+    bits = KnownBitsKernels::extraBits(
+        ric, combined.meet(KnownBitsKernels::fromRIC(ric)));
+}
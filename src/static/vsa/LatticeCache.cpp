@@ -0,0 +1,51 @@
+#include <static/vsa/LatticeCache.hpp>
+
+LatticeCache &LatticeCache::getCache() {
+    static LatticeCache cache;
+    return cache;
+}
+
+/// @brief Look up the result of `lhs op rhs`, computing (and caching) it if
+/// it is not already in the table.
+ValueSetRef LatticeCache::apply(Op op, ValueSetRef lhs, ValueSetRef rhs) {
+    uint64_t key = ((uint64_t)lhs.getId() << 32) | rhs.getId();
+    key = (key ^ (key >> 29) ^ op) * 0xbf58476d1ce4e5b9ULL;
+
+    Entry &entry = this->entries[(key >> 32) & (CAPACITY - 1)];
+
+    if (entry.op == op && entry.lhs == lhs.getId() &&
+        entry.rhs == rhs.getId()) {
+        this->hits++;
+        return ValueSetRef::fromId(entry.result);
+    }
+
+    this->misses++;
+
+    ValueSet result = lhs;
+    ValueSet rhsSet = rhs;
+    bool changed = false;
+
+    switch (op) {
+    case Join:
+        changed = result.joinWith(rhsSet);
+        break;
+    case Widen:
+        changed = result.widenWith(rhsSet);
+        break;
+    case Narrow:
+        changed = result.narrowWith(rhsSet);
+        break;
+    case None:
+        break;
+    }
+
+    // An unchanged result doesn't need to be interned again
+    ValueSetRef resultRef = changed ? ValueSetRef(result) : lhs;
+
+    entry.op = op;
+    entry.lhs = lhs.getId();
+    entry.rhs = rhs.getId();
+    entry.result = resultRef.getId();
+
+    return resultRef;
+}
@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <numeric>
 #include <static/vsa/RIC.hpp>
 
@@ -20,23 +22,6 @@ void RIC::set(const RIC &ric) {
     this->stride = ric.stride;
 }
 
-bool RIC::isBottom() {
-    return this->start.is_plus_infinity() && this->end.is_minus_infinity();
-}
-
-bool RIC::isTop() {
-    return this->start.is_minus_infinity() && this->end.is_plus_infinity() &&
-           this->stride == 1;
-}
-
-SVF::BoundedInt RIC::lower() {
-    return this->offset + (this->stride * this->start);
-}
-
-SVF::BoundedInt RIC::upper() {
-    return this->offset + (this->stride * this->end);
-}
-
 bool RIC::isSubset(RIC &rhs) {
     // Edgecase: LHS is bottom, always true
     if (this->isBottom()) {
@@ -60,8 +45,8 @@ bool RIC::isSubset(RIC &rhs) {
 
     // Edgecase: LHS has only one element
     if (this->start == this->end) {
-        SVF::BoundedInt singleValue = this->lower();
-        SVF::BoundedInt rhsIndex = (singleValue - rhs.offset) / rhs.stride;
+        Bound singleValue = this->lower();
+        Bound rhsIndex = (singleValue - rhs.offset) / rhs.stride;
 
         return rhsIndex >= rhs.start && rhsIndex <= rhs.end;
     }
@@ -72,11 +57,11 @@ bool RIC::isSubset(RIC &rhs) {
         return false;
     }
 
-    SVF::BoundedInt rawLower = this->lower();
-    SVF::BoundedInt rawUpper = this->upper();
+    Bound rawLower = this->lower();
+    Bound rawUpper = this->upper();
 
-    SVF::BoundedInt rhsLowerIndex = (rawLower - rhs.offset) / rhs.stride;
-    SVF::BoundedInt rhsUpperIndex = (rawUpper - rhs.offset) / rhs.stride;
+    Bound rhsLowerIndex = (rawLower - rhs.offset) / rhs.stride;
+    Bound rhsUpperIndex = (rawUpper - rhs.offset) / rhs.stride;
 
     if (rhsLowerIndex < rhs.start || rhsUpperIndex > rhs.end) {
         return false;
@@ -85,6 +70,64 @@ bool RIC::isSubset(RIC &rhs) {
     return true;
 }
 
+/// @brief Extended Euclidean algorithm.
+/// @return gcd(a, b), with `x` and `y` set so that a * x + b * y = gcd(a, b)
+static int64_t extendedGcd(int64_t a, int64_t b, int64_t &x, int64_t &y) {
+    int64_t oldR = a, r = b;
+    int64_t oldX = 1, curX = 0;
+    int64_t oldY = 0, curY = 1;
+
+    while (r != 0) {
+        int64_t quotient = oldR / r;
+
+        int64_t tmp = oldR - quotient * r;
+        oldR = r;
+        r = tmp;
+
+        tmp = oldX - quotient * curX;
+        oldX = curX;
+        curX = tmp;
+
+        tmp = oldY - quotient * curY;
+        oldY = curY;
+        curY = tmp;
+    }
+
+    x = oldX;
+    y = oldY;
+    return oldR;
+}
+
+/// @brief Solves the system x = a (mod m), x = b (mod n) using the Chinese
+/// remainder theorem, in O(log min(m, n)) steps.
+/// @param residue set to the smallest non-negative solution
+/// @param modulus set to lcm(m, n)
+/// @return false if there is no solution
+static bool solveCongruences(int64_t a, int64_t m, int64_t b, int64_t n,
+                             int64_t &residue, int64_t &modulus) {
+    int64_t p, q;
+    int64_t g = extendedGcd(m, n, p, q);
+
+    if ((b - a) % g != 0) {
+        return false;
+    }
+
+    // m * p = g (mod n), so x = a + m * p * (b - a) / g solves both
+    int64_t reducedN = n / g;
+    int64_t k = ((b - a) / g) % reducedN * (p % reducedN) % reducedN;
+    if (k < 0) {
+        k += reducedN;
+    }
+
+    modulus = m * reducedN;
+    residue = (a + m * k) % modulus;
+    if (residue < 0) {
+        residue += modulus;
+    }
+
+    return true;
+}
+
 /// @brief Overwrite this RIC with the intersection (meet) of
 /// this and another RIC.
 /// @param rhs The RIC to meet with.
@@ -103,11 +146,11 @@ void RIC::meetWith(RIC &rhs) {
         return;
     }
 
-    SVF::BoundedInt lhsLower = this->lower();
-    SVF::BoundedInt rhsLower = rhs.lower();
+    Bound lhsLower = this->lower();
+    Bound rhsLower = rhs.lower();
 
-    SVF::BoundedInt lhsUpper = this->upper();
-    SVF::BoundedInt rhsUpper = rhs.upper();
+    Bound lhsUpper = this->upper();
+    Bound rhsUpper = rhs.upper();
 
     // Two ranges don't overlap
     if (lhsUpper < rhsLower || rhsUpper < lhsLower) {
@@ -115,75 +158,90 @@ void RIC::meetWith(RIC &rhs) {
         return;
     }
 
-    std::vector<SVF::BoundedInt> lowerCandidates = {lhsLower, rhsLower};
-    SVF::BoundedInt lower = SVF::BoundedInt::max(lowerCandidates);
-    std::vector<SVF::BoundedInt> upperCandidates = {lhsUpper, rhsUpper};
-    SVF::BoundedInt upper = SVF::BoundedInt::min(upperCandidates);
+    Bound lower = std::max(lhsLower, rhsLower);
+    Bound upper = std::min(lhsUpper, rhsUpper);
 
-    int stride = std::lcm(this->stride, rhs.stride);
+    // Every common element `x` satisfies x = this->offset (mod this->stride)
+    // and x = rhs.offset (mod rhs.stride), so by the CRT the common
+    // elements are exactly one residue class modulo the LCM of the strides
+    int64_t residue;
+    int64_t stride;
+    if (!solveCongruences(this->offset, this->stride, rhs.offset, rhs.stride,
+                          residue, stride)) {
+        this->set(BOTTOM);
+        return;
+    }
 
     // Our first "candidate" of some value that both RICs could contain
     // is between `lower` and `upper`.
-    int candidate;
+    Bound candidate;
     if (lower.is_minus_infinity() && upper.is_plus_infinity()) {
         candidate = 0;
     } else if (lower.is_minus_infinity()) {
-        candidate = (upper - stride).getIntNumeral();
+        candidate = upper - (stride - 1);
     } else {
-        candidate = lower.getIntNumeral();
+        candidate = lower;
     }
 
-    // We are guaranteed that there is at most one place of overlap between
-    // our candidate and `candidate + stride`. If we find such a candidate,
-    // then every `candidate + stride * x` within bounds is in our new
-    // RIC.
-    for (int i = 0; i < stride; i++) {
-        if (candidate > upper) {
-            break;
-        }
+    // Move the candidate up to the first member of the residue class
+    int64_t shift = (residue - candidate.getIntNumeral() % stride) % stride;
+    if (shift < 0) {
+        shift += stride;
+    }
 
-        int check = candidate + i;
+    Bound first = candidate + shift;
 
-        // Check if the current value is in *both* RICs
-        if ((check - this->offset) % this->stride != 0) {
-            continue;
-        }
+    // We've gone through all possible candidates within range and no
+    // values overlap, therefore the meet set is empty
+    if (first > upper) {
+        this->set(BOTTOM);
+        return;
+    }
 
-        if ((check - rhs.offset) % rhs.stride != 0) {
-            continue;
+    if (stride > std::numeric_limits<int>::max()) {
+        // The LCM is too large to be stored as a stride - either there is
+        // only one common element, or we keep `this`, which is still a
+        // sound overapproximation of the meet
+        if (!lower.is_minus_infinity() && first + stride > upper) {
+            this->set(RIC(first.getIntNumeral()));
         }
 
-        this->stride = stride;
-        // Our candidate is either the lowest possible value of overlap,
-        // or our starting bound is -inf
-        this->start = lower.is_minus_infinity() ? lower : 0;
-        this->end = upper.is_plus_infinity()
-                        ? upper
-                        : (upper - this->offset).getIntNumeral() / stride;
-        this->offset = check;
         return;
     }
 
-    // We've gone through all possible candidates within range and no
-    // values overlap, therefore the meet set is empty
-    this->set(BOTTOM);
+    // A single common element is stored as a plain constant, so that it
+    // compares equal to any other RIC of that constant
+    if (!lower.is_minus_infinity() && first + stride > upper) {
+        this->set(RIC(first.getIntNumeral()));
+        return;
+    }
+
+    this->stride = stride;
+    // Our candidate is either the lowest possible value of overlap,
+    // or our starting bound is -inf
+    this->start = lower.is_minus_infinity() ? lower : 0;
+    this->end = upper.is_plus_infinity() ? upper : (upper - first) / stride;
+    this->offset = first.getIntNumeral();
 }
 
 /// @brief Overwrite this RIC with the union (join) of this and another RIC.
 /// @param rhs The RIC to join with.
-void RIC::joinWith(RIC &rhs) {
+/// @return Whether this RIC changed
+bool RIC::joinWith(RIC &rhs) {
+    RIC before = *this;
+
     if (this->isTop() || rhs.isBottom()) {
-        return;
+        return false;
     }
 
     if (this->isBottom()) {
         this->set(rhs);
-        return;
+        return *this != before;
     }
 
     if (rhs.isTop()) {
         this->set(TOP);
-        return;
+        return *this != before;
     }
 
     if (this->isConstant() && rhs.isConstant()) {
@@ -191,14 +249,14 @@ void RIC::joinWith(RIC &rhs) {
         int rhsConstant = rhs.getConstant();
 
         if (thisConstant == rhsConstant) {
-            return;
+            return false;
         }
 
         this->stride = std::abs(thisConstant - rhsConstant);
         this->start = 0;
         this->end = 1;
         this->offset = std::min(thisConstant, rhsConstant);
-        return;
+        return *this != before;
     }
 
     if (this->isConstant()) {
@@ -207,16 +265,14 @@ void RIC::joinWith(RIC &rhs) {
         rhs.stride = this->stride;
     }
 
-    SVF::BoundedInt lhsLower = this->lower();
-    SVF::BoundedInt rhsLower = rhs.lower();
+    Bound lhsLower = this->lower();
+    Bound rhsLower = rhs.lower();
 
-    SVF::BoundedInt lhsUpper = this->upper();
-    SVF::BoundedInt rhsUpper = rhs.upper();
+    Bound lhsUpper = this->upper();
+    Bound rhsUpper = rhs.upper();
 
-    std::vector<SVF::BoundedInt> lowerCandidates = {lhsLower, rhsLower};
-    SVF::BoundedInt lower = SVF::BoundedInt::min(lowerCandidates);
-    std::vector<SVF::BoundedInt> upperCandidates = {lhsUpper, rhsUpper};
-    SVF::BoundedInt upper = SVF::BoundedInt::max(upperCandidates);
+    Bound lower = std::min(lhsLower, rhsLower);
+    Bound upper = std::max(lhsUpper, rhsUpper);
 
     // First candidate stride: GCD of both strides
     int stride = std::gcd(this->stride, rhs.stride);
@@ -236,52 +292,60 @@ void RIC::joinWith(RIC &rhs) {
     this->end = (upper - lower) / stride;
     this->offset =
         lower.is_minus_infinity() ? offsetDiff : lower.getIntNumeral();
+
+    return *this != before;
 }
 
-void RIC::widenWith(RIC &rhs) {
+bool RIC::widenWith(RIC &rhs) {
+    RIC before = *this;
+
     if (this->isConstant()) {
         this->stride = rhs.stride;
     }
 
     // Ignore cases where strides are different
     if (this->stride != rhs.stride) {
-        return;
+        return *this != before;
     }
 
     // Adjust RHS, so that the offsets are the same
     int adjust = rhs.offset - this->offset;
     if (adjust % this->stride != 0) {
-        return;
+        return *this != before;
     }
 
     int adjustSteps = adjust / this->stride;
-    SVF::BoundedInt newStart = rhs.start - adjustSteps;
-    SVF::BoundedInt newEnd = rhs.end - adjustSteps;
+    Bound newStart = rhs.start - adjustSteps;
+    Bound newEnd = rhs.end - adjustSteps;
 
     if (newStart < this->start) {
-        this->start = SVF::BoundedInt::minus_infinity();
+        this->start = Bound::minus_infinity();
     }
 
     if (newEnd > this->end) {
-        this->end = SVF::BoundedInt::plus_infinity();
+        this->end = Bound::plus_infinity();
     }
+
+    return *this != before;
 }
 
-void RIC::narrowWith(RIC &rhs) {
+bool RIC::narrowWith(RIC &rhs) {
+    RIC before = *this;
+
     // Ignore cases where strides are different
     if (this->stride != rhs.stride) {
-        return;
+        return false;
     }
 
     // Adjust RHS, so that the offsets are the same
     int adjust = rhs.offset - this->offset;
     if (adjust % this->stride != 0) {
-        return;
+        return false;
     }
 
     int adjustSteps = adjust / this->stride;
-    SVF::BoundedInt newStart = rhs.start - adjustSteps;
-    SVF::BoundedInt newEnd = rhs.end - adjustSteps;
+    Bound newStart = rhs.start - adjustSteps;
+    Bound newEnd = rhs.end - adjustSteps;
 
     if (this->start.is_minus_infinity()) {
         this->start = newStart;
@@ -290,6 +354,8 @@ void RIC::narrowWith(RIC &rhs) {
     if (this->end.is_plus_infinity()) {
         this->end = newEnd;
     }
+
+    return *this != before;
 }
 
 bool RIC::contains(int val) {
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <static/vsa/RegionMap.hpp>
+
+RegionMap::RegionMap(const RegionMap &rhs) {
+    this->reserve(rhs.count);
+    std::copy(rhs.begin(), rhs.end(), this->data());
+    this->count = rhs.count;
+}
+
+RegionMap::RegionMap(RegionMap &&rhs) noexcept {
+    if (rhs.heap) {
+        // Steal the heap buffer
+        this->heap = rhs.heap;
+        this->capacity = rhs.capacity;
+        rhs.heap = nullptr;
+        rhs.capacity = INLINE_CAPACITY;
+    } else {
+        std::copy(rhs.begin(), rhs.end(), this->inlineEntries);
+    }
+
+    this->count = rhs.count;
+    rhs.count = 0;
+}
+
+RegionMap &RegionMap::operator=(const RegionMap &rhs) {
+    if (this != &rhs) {
+        this->count = 0;
+        this->reserve(rhs.count);
+        std::copy(rhs.begin(), rhs.end(), this->data());
+        this->count = rhs.count;
+    }
+
+    return *this;
+}
+
+RegionMap &RegionMap::operator=(RegionMap &&rhs) noexcept {
+    if (this != &rhs) {
+        delete[] this->heap;
+        this->heap = nullptr;
+        this->capacity = INLINE_CAPACITY;
+
+        if (rhs.heap) {
+            this->heap = rhs.heap;
+            this->capacity = rhs.capacity;
+            rhs.heap = nullptr;
+            rhs.capacity = INLINE_CAPACITY;
+        } else {
+            std::copy(rhs.begin(), rhs.end(), this->inlineEntries);
+        }
+
+        this->count = rhs.count;
+        rhs.count = 0;
+    }
+
+    return *this;
+}
+
+/// @brief Make sure that there is space for at least `n` entries, moving
+/// onto the heap if `n` is larger than the inline capacity.
+void RegionMap::reserve(uint32_t n) {
+    if (n <= this->capacity) {
+        return;
+    }
+
+    uint32_t newCapacity = std::max(n, this->capacity * 2);
+    RegionEntry *newHeap = new RegionEntry[newCapacity];
+    std::copy(this->begin(), this->end(), newHeap);
+
+    delete[] this->heap;
+    this->heap = newHeap;
+    this->capacity = newCapacity;
+}
+
+RegionMap::iterator RegionMap::lowerBound(RegionID region) {
+    return std::lower_bound(this->begin(), this->end(), region,
+                            [](const RegionEntry &entry, RegionID region) {
+                                return entry.first < region;
+                            });
+}
+
+RegionMap::iterator RegionMap::find(RegionID region) {
+    iterator it = this->lowerBound(region);
+    return (it != this->end() && it->first == region) ? it : this->end();
+}
+
+RegionMap::const_iterator RegionMap::find(RegionID region) const {
+    return const_cast<RegionMap *>(this)->find(region);
+}
+
+/// @brief Find the RIC for a region, inserting an empty (bottom) RIC if the
+/// region is not in the map yet, as with `std::map`. The RIC may be
+/// overwritten through the returned reference, so the region's known bits
+/// are dropped rather than left stale.
+RIC &RegionMap::operator[](RegionID region) {
+    iterator it = this->insert({region, RIC()}).first;
+    it->bits = KnownBits();
+    return it->second;
+}
+
+/// @brief Insert an entry, unless its region is already in the map.
+/// @return An iterator to the entry with that region, and whether it was
+/// newly inserted.
+std::pair<RegionMap::iterator, bool>
+RegionMap::insert(const RegionEntry &entry) {
+    iterator it = this->lowerBound(entry.first);
+    if (it != this->end() && it->first == entry.first) {
+        return {it, false};
+    }
+
+    size_t index = it - this->begin();
+    this->reserve(this->count + 1);
+
+    iterator pos = this->begin() + index;
+    std::copy_backward(pos, this->end(), this->end() + 1);
+    *pos = entry;
+    this->count++;
+
+    return {pos, true};
+}
+
+RegionMap::iterator RegionMap::erase(iterator it) {
+    return this->erase(it, it + 1);
+}
+
+RegionMap::iterator RegionMap::erase(iterator first, iterator last) {
+    iterator newEnd = std::copy(last, this->end(), first);
+    this->count = newEnd - this->begin();
+    return first;
+}
+
+void RegionMap::pushBack(const RegionEntry &entry) {
+    this->reserve(this->count + 1);
+    this->data()[this->count] = entry;
+    this->count++;
+}
+
+bool RegionMap::operator==(const RegionMap &rhs) const {
+    if (this->count != rhs.count) {
+        return false;
+    }
+
+    return std::equal(this->begin(), this->end(), rhs.begin(),
+                      [](const RegionEntry &lhs, const RegionEntry &rhs) {
+                          return lhs.first == rhs.first &&
+                                 lhs.second == rhs.second &&
+                                 lhs.bits == rhs.bits;
+                      });
+}
@@ -0,0 +1,58 @@
+#include <unordered_map>
+
+#include <static/vsa/RegisterFile.hpp>
+
+/// @brief Every name Remill gives to (parts of) the general-purpose
+/// registers, mapped to the slot and bytes that they cover.
+static std::unordered_map<std::string, RegisterAlias> buildAliases() {
+    struct Names {
+        Register reg;
+        const char *full;
+        const char *dword;
+        const char *word;
+        const char *lowByte;
+        const char *highByte;
+    };
+
+    const Names NAMES[] = {
+        {Register::RAX, "RAX", "EAX", "AX", "AL", "AH"},
+        {Register::RBX, "RBX", "EBX", "BX", "BL", "BH"},
+        {Register::RCX, "RCX", "ECX", "CX", "CL", "CH"},
+        {Register::RDX, "RDX", "EDX", "DX", "DL", "DH"},
+        {Register::RSI, "RSI", "ESI", "SI", "SIL", nullptr},
+        {Register::RDI, "RDI", "EDI", "DI", "DIL", nullptr},
+        {Register::RBP, "RBP", "EBP", "BP", "BPL", nullptr},
+        {Register::RSP, "RSP", "ESP", "SP", "SPL", nullptr},
+        {Register::R8, "R8", "R8D", "R8W", "R8B", nullptr},
+        {Register::R9, "R9", "R9D", "R9W", "R9B", nullptr},
+        {Register::R10, "R10", "R10D", "R10W", "R10B", nullptr},
+        {Register::R11, "R11", "R11D", "R11W", "R11B", nullptr},
+        {Register::R12, "R12", "R12D", "R12W", "R12B", nullptr},
+        {Register::R13, "R13", "R13D", "R13W", "R13B", nullptr},
+        {Register::R14, "R14", "R14D", "R14W", "R14B", nullptr},
+        {Register::R15, "R15", "R15D", "R15W", "R15B", nullptr},
+    };
+
+    std::unordered_map<std::string, RegisterAlias> aliases;
+
+    for (const Names &names : NAMES) {
+        aliases[names.full] = {names.reg, 8, 0};
+        aliases[names.dword] = {names.reg, 4, 0};
+        aliases[names.word] = {names.reg, 2, 0};
+        aliases[names.lowByte] = {names.reg, 1, 0};
+
+        if (names.highByte) {
+            aliases[names.highByte] = {names.reg, 1, 1};
+        }
+    }
+
+    return aliases;
+}
+
+RegisterAlias RegisterAlias::fromName(const std::string &name) {
+    static const std::unordered_map<std::string, RegisterAlias> ALIASES =
+        buildAliases();
+
+    auto it = ALIASES.find(name);
+    return it == ALIASES.end() ? RegisterAlias() : it->second;
+}
@@ -0,0 +1,13 @@
+#include <static/vsa/StoreArena.hpp>
+
+static std::pmr::memory_resource *currentResource =
+    std::pmr::new_delete_resource();
+
+std::pmr::memory_resource *StoreArena::current() { return currentResource; }
+
+StoreArena::Scope::Scope(std::pmr::memory_resource *resource)
+    : previous(currentResource) {
+    currentResource = resource;
+}
+
+StoreArena::Scope::~Scope() { currentResource = this->previous; }
@@ -0,0 +1,57 @@
+#include <static/vsa/StoreKernels.hpp>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(ValueSetRef) == sizeof(uint32_t),
+              "value set handles must be packed 32-bit IDs");
+
+uint64_t StoreKernels::diffMask(const ValueSetRef *lhs, const ValueSetRef *rhs,
+                                size_t n) {
+    uint64_t mask = 0;
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    // 8 handles per step
+    for (; i + 8 <= n; i += 8) {
+        __m256i l = _mm256_loadu_si256((const __m256i *)(lhs + i));
+        __m256i r = _mm256_loadu_si256((const __m256i *)(rhs + i));
+        __m256i cmp = _mm256_cmpeq_epi32(l, r);
+        int eq = _mm256_movemask_ps(_mm256_castsi256_ps(cmp));
+        mask |= (uint64_t)(~eq & 0xff) << i;
+    }
+#endif
+
+#if defined(__SSE2__)
+    // 4 handles per step
+    for (; i + 4 <= n; i += 4) {
+        __m128i l = _mm_loadu_si128((const __m128i *)(lhs + i));
+        __m128i r = _mm_loadu_si128((const __m128i *)(rhs + i));
+        __m128i cmp = _mm_cmpeq_epi32(l, r);
+        int eq = _mm_movemask_ps(_mm_castsi128_ps(cmp));
+        mask |= (uint64_t)(~eq & 0xf) << i;
+    }
+#endif
+
+    for (; i < n; i++) {
+        if (lhs[i] != rhs[i]) {
+            mask |= (uint64_t)1 << i;
+        }
+    }
+
+    return mask;
+}
+
+bool StoreKernels::equal(const ValueSetRef *lhs, const ValueSetRef *rhs,
+                         size_t n) {
+    for (size_t base = 0; base < n; base += CHUNK) {
+        size_t len = (n - base < CHUNK) ? n - base : CHUNK;
+
+        if (diffMask(lhs + base, rhs + base, len) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -1,5 +1,9 @@
+#include <algorithm>
+
 #include <WPA/Andersen.h>
 
+#include <static/vsa/KnownBits.hpp>
+#include <static/vsa/RICKernels.hpp>
 #include <static/vsa/VSA.hpp>
 
 // according to varieties of cmp insts,
@@ -78,36 +82,60 @@ SVF::Map<SVF::s32_t, SVF::s32_t> _switch_lhsrhs_predicate = {
      SVF::CmpStmt::Predicate::ICMP_SLE}, // >= -> <=
 };
 
-const std::map<std::string, size_t> READ_FNS_TO_SIZES = {
-    {"__remill_read_memory_8", 1},
-    {"__remill_read_memory_16", 2},
-    {"__remill_read_memory_32", 4},
-    {"__remill_read_memory_64", 8}};
+void VSA::setALocs(std::vector<ALoc> alocs) {
+    StoreArena::Scope scope(&this->arena);
 
-const std::map<std::string, size_t> WRITE_FNS_TO_SIZES = {
-    {"__remill_write_memory_8", 1},
-    {"__remill_write_memory_16", 2},
-    {"__remill_write_memory_32", 4},
-    {"__remill_write_memory_64", 8}};
+    for (ALoc aloc : alocs) {
+        ALocID id = this->alocTable.intern(aloc);
+        this->blockState.abstractStore.alocs[id] = ValueSet();
+    }
+}
 
-void Snapshot::initSVFVar(SVF::ValVar *valVar) {
-    SVF::NodeID varId = valVar->getId();
+/// @brief Number the nodes of a list of WTO components in order, heads of
+/// cycles before the bodies of their cycles.
+static void numberWTOComponents(
+    const std::list<const SVF::ICFGWTOComp *> &components,
+    std::vector<uint32_t> &order, uint32_t &next) {
+    auto number = [&](const SVF::ICFGNode *node) {
+        if (node->getId() >= order.size()) {
+            order.resize(node->getId() + 1, UINT32_MAX);
+        }
 
-    // Currently only handles ConstIntValVar and ConstNullPtrValVar
-    if (const SVF::ConstIntValVar *consInt =
-            SVF::SVFUtil::dyn_cast<SVF::ConstIntValVar>(valVar)) {
-        SVF::s64_t numeral = consInt->getSExtValue();
-        this->varState[varId] = ValueSet(numeral);
-    } else if (SVF::SVFUtil::isa<SVF::ConstNullPtrValVar>(valVar)) {
-        this->varState[varId] = ValueSet(0);
-    }
+        order[node->getId()] = next++;
+    };
 
-    return;
+    for (const SVF::ICFGWTOComp *comp : components) {
+        if (const SVF::ICFGCycleWTO *cycle =
+                SVF::SVFUtil::dyn_cast<SVF::ICFGCycleWTO>(comp)) {
+            number(cycle->head()->getICFGNode());
+            numberWTOComponents(cycle->getWTOComponents(), order, next);
+        } else {
+            number(SVF::SVFUtil::dyn_cast<SVF::ICFGSingletonWTO>(comp)
+                       ->getICFGNode());
+        }
+    }
 }
 
-void VSA::setALocs(std::vector<ALoc> alocs) {
-    for (ALoc aloc : alocs) {
-        this->blockState.abstractStore.alocs[aloc] = ValueSet();
+/// @brief Set a flag on every node of a cycle, including the nodes of its
+/// inner cycles.
+static void markCycleNodes(const SVF::ICFGCycleWTO *cycle,
+                           std::vector<uint8_t> &flags, uint8_t flag) {
+    auto mark = [&](const SVF::ICFGNode *node) {
+        if (node->getId() < flags.size()) {
+            flags[node->getId()] |= flag;
+        }
+    };
+
+    mark(cycle->head()->getICFGNode());
+
+    for (const SVF::ICFGWTOComp *comp : cycle->getWTOComponents()) {
+        if (const SVF::ICFGCycleWTO *subCycle =
+                SVF::SVFUtil::dyn_cast<SVF::ICFGCycleWTO>(comp)) {
+            markCycleNodes(subCycle, flags, flag);
+        } else {
+            mark(SVF::SVFUtil::dyn_cast<SVF::ICFGSingletonWTO>(comp)
+                     ->getICFGNode());
+        }
     }
 }
 
@@ -142,7 +170,13 @@ void VSA::initWTO() {
         this->funcToWTO[fun] = wto;
     }
 
+    this->wtoOrder.assign(this->icfg->getTotalNodeNum(), UINT32_MAX);
+    uint32_t next = 0;
+
     for (auto fun : this->funcToWTO) {
+        numberWTOComponents(fun.second->getWTOComponents(), this->wtoOrder,
+                            next);
+
         for (const SVF::ICFGWTOComp *comp : fun.second->getWTOComponents()) {
             if (const SVF::ICFGCycleWTO *cycle =
                     SVF::SVFUtil::dyn_cast<SVF::ICFGCycleWTO>(comp)) {
@@ -152,17 +186,69 @@ void VSA::initWTO() {
     }
 }
 
+/// @brief Number every node that starts or ends a basic block, in ICFG
+/// order (so the blocks of each function are numbered contiguously), and
+/// size the pre/post state tables to fit them.
+void VSA::initBlockIds() {
+    this->blockIds.assign(this->icfg->getTotalNodeNum(), NO_BLOCK);
+
+    for (const auto &item : *this->icfg) {
+        const SVF::ICFGNode *node = item.second;
+        bool endsBlock = false;
+
+        for (const SVF::SVFStmt *stmt : node->getSVFStmts()) {
+            if (SVF::SVFUtil::isa<SVF::BranchStmt>(stmt)) {
+                endsBlock = true;
+                break;
+            }
+        }
+
+        if (endsBlock || this->isStartOfBasicBlock(node) ||
+            this->cycleHeadToCycle.count(node)) {
+            this->getBlockId(node);
+        }
+    }
+
+    this->preBasicBlock.reserve(this->blockCount);
+    this->postBasicBlock.reserve(this->blockCount);
+}
+
+/// @brief Find the dense block number of a node, numbering it now if it
+/// wasn't numbered up front.
+BlockID VSA::getBlockId(const SVF::ICFGNode *node) {
+    SVF::NodeID id = node->getId();
+    if (id >= this->blockIds.size()) {
+        this->blockIds.resize(id + 1, NO_BLOCK);
+    }
+
+    if (this->blockIds[id] == NO_BLOCK) {
+        this->blockIds[id] = this->blockCount++;
+    }
+
+    return this->blockIds[id];
+}
+
 void VSA::handleGlobalNode() {
     const SVF::ICFGNode *globalNode = this->icfg->getGlobalICFGNode();
 
     // Run through each global variable assignment
-    for (const SVF::SVFStmt *stmt : globalNode->getSVFStmts()) {
-        updateAbsState(stmt);
+    this->runNode(globalNode);
+
+    // Now everything should be stored in this->blockState (or the sparse
+    // table) - move all variables into this->globalState
+    if (this->sparse) {
+        for (SVF::NodeID id = 0; id < this->sparseDefined.size(); id++) {
+            if (this->sparseDefined[id]) {
+                this->globalState[id] = this->sparseVars[id];
+            }
+        }
+
+        this->sparseVars.clear();
+        this->sparseDefined.clear();
+    } else {
+        this->globalState = this->blockState.varState;
     }
 
-    // Now everything should be stored in this->blockState - move all
-    // variables into this->globalState
-    this->globalState = this->blockState.varState;
     this->blockState.varState.clear();
 }
 
@@ -191,7 +277,7 @@ void VSA::handleMainFunction(const SVF::FunObjVar *main) {
         SVF::SVFUtil::dyn_cast<SVF::CallICFGNode>(callEntryIcfgNode);
     auto initialPcVar = callEntryNode->getActualParms()[1];
 
-    auto initialPcConst = this->globalState[initialPcVar->getId()];
+    ValueSet initialPcConst = this->globalState[initialPcVar->getId()];
     this->pc = initialPcConst.getConstant();
 
     // Continue on with AE for actual entry point
@@ -200,10 +286,33 @@ void VSA::handleMainFunction(const SVF::FunObjVar *main) {
     handleFunction(funEntryNode);
 }
 
-void VSA::analyse() {
+/// @brief Set up everything that doesn't depend on which data accesses
+/// are wanted. Only the first call (from `analyse` or `queryAccess`) does
+/// anything.
+void VSA::prepare() {
+    if (this->prepared) {
+        return;
+    }
+
+    this->prepared = true;
+
     initWTO();
+    initNodeLayout();
+    initBlockIds();
+    initVarRoles();
 
     handleGlobalNode();
+    this->initialState = this->blockState;
+}
+
+/// @brief Analyse the program from `main`, starting from the state right
+/// after the global node.
+void VSA::analyseFromMain() {
+    this->preBasicBlock.clear();
+    this->postBasicBlock.clear();
+    this->sparseVars.clear();
+    this->sparseDefined.clear();
+    this->blockState = this->initialState;
 
     // Process the main function if it exists
     if (const SVF::FunObjVar *fun = svfir->getFunObjVar("main")) {
@@ -211,6 +320,157 @@ void VSA::analyse() {
     }
 }
 
+void VSA::analyse() {
+    StoreArena::Scope scope(&this->arena);
+
+    this->prepare();
+    this->analyseFromMain();
+}
+
+/// @brief Find the address and size of one data access, only analysing the
+/// parts of the program that can run before it (see `computeSlice`).
+/// Accesses found by earlier queries (or by `analyse`) are cached, as are
+/// accesses that a query found are never reached. Every query also caches
+/// the other accesses it finds that a full analysis would find the same
+/// (see `isSliceComplete`), so later queries for those return straight
+/// away.
+/// @param callNodeId ID of the call to `__remill_read_memory_*`,
+/// `__remill_write_memory_*` or `scanf` making the access
+/// @return The value set of the address and the size of the access - an
+/// empty value set and size 0 if the access is never reached
+std::pair<ValueSet, size_t> VSA::queryAccess(SVF::NodeID callNodeId) {
+    auto cached = this->dataAccesses.find(callNodeId);
+    if (cached != this->dataAccesses.end()) {
+        return cached->second;
+    }
+
+    if (this->unreachedAccesses.count(callNodeId)) {
+        return {ValueSet(), 0};
+    }
+
+    StoreArena::Scope scope(&this->arena);
+
+    this->prepare();
+    this->computeSlice(this->icfg->getICFGNode(callNodeId));
+
+    this->slicing = true;
+    this->analyseFromMain();
+    this->slicing = false;
+
+    cached = this->dataAccesses.find(callNodeId);
+    if (cached == this->dataAccesses.end()) {
+        this->unreachedAccesses.insert(callNodeId);
+        return {ValueSet(), 0};
+    }
+
+    return cached->second;
+}
+
+/**
+ * @brief Find the backward slice of the control flow leading to a node
+ *
+ * Marks every node that can run before `target`, following ICFG edges
+ * backwards across calls and returns (and from a return node back to its
+ * call). The slice is closed under predecessors, so each block in it merges
+ * exactly the same states as in a full analysis, and nodes outside it can
+ * be skipped in every function that has a node in the slice. Functions
+ * outside the slice are only reached through calls from inside it, and are
+ * analysed in full.
+ *
+ * @param target The node whose state is wanted
+ */
+void VSA::computeSlice(const SVF::ICFGNode *target) {
+    this->slice.assign(this->nodeFlags.size(), false);
+    this->sliceFuns.clear();
+    this->completeFuns.clear();
+
+    std::vector<const SVF::ICFGNode *> stack;
+
+    auto visit = [&](const SVF::ICFGNode *node) {
+        SVF::NodeID id = node->getId();
+        if (id >= this->slice.size()) {
+            this->slice.resize(id + 1, false);
+        }
+
+        if (!this->slice[id]) {
+            this->slice[id] = true;
+            stack.push_back(node);
+        }
+    };
+
+    visit(target);
+
+    while (!stack.empty()) {
+        const SVF::ICFGNode *node = stack.back();
+        stack.pop_back();
+        this->sliceFuns.insert(node->getFun());
+
+        for (const SVF::ICFGEdge *edge : node->getInEdges()) {
+            visit(edge->getSrcNode());
+        }
+
+        // The analysis goes straight from a call to its return node
+        if (const SVF::RetICFGNode *retNode =
+                SVF::SVFUtil::dyn_cast<SVF::RetICFGNode>(node)) {
+            visit(retNode->getCallICFGNode());
+        }
+    }
+}
+
+/// Whether a node needs to be analysed for the current query
+bool VSA::isInSlice(const SVF::ICFGNode *node) const {
+    if (!this->slicing ||
+        this->sliceFuns.find(node->getFun()) == this->sliceFuns.end()) {
+        return true;
+    }
+
+    SVF::NodeID id = node->getId();
+    return id < this->slice.size() && this->slice[id];
+}
+
+/// @brief Whether a function is run in every context that it is run in by
+/// a full analysis, i.e. every call to it is in the slice of the current
+/// query. Functions with a node in the slice always are, since the slice
+/// includes every call to them, but functions only called from inside the
+/// slice may also be called from outside it. Accesses in other functions
+/// are only found in some of their contexts, so they aren't cached.
+bool VSA::isSliceComplete(const SVF::FunObjVar *fun) {
+    if (!this->slicing || this->sliceFuns.count(fun)) {
+        return true;
+    }
+
+    auto cached = this->completeFuns.find(fun);
+    if (cached != this->completeFuns.end()) {
+        return cached->second;
+    }
+
+    bool complete = true;
+    const SVF::ICFGNode *entry = this->icfg->getFunEntryICFGNode(fun);
+
+    for (const SVF::ICFGEdge *edge : entry->getInEdges()) {
+        SVF::NodeID id = edge->getSrcNode()->getId();
+        if (id >= this->slice.size() || !this->slice[id]) {
+            complete = false;
+            break;
+        }
+    }
+
+    this->completeFuns[fun] = complete;
+    return complete;
+}
+
+/// @brief Record the address and size of a data access. Accesses in cycles
+/// are only recorded once the cycle is being narrowed.
+void VSA::recordAccess(const SVF::CallICFGNode *callNode, ValueSet address,
+                       size_t size) {
+    if ((this->isInCycle && !this->narrowing) ||
+        !this->isSliceComplete(callNode->getFun())) {
+        return;
+    }
+
+    this->dataAccesses[callNode->getId()] = {address, size};
+}
+
 std::map<SVF::NodeID, std::pair<ValueSet, size_t>> VSA::getDataAccesses() {
     return this->dataAccesses;
 }
@@ -229,9 +489,52 @@ ValueSet VSA::getSVFVarSet(SVF::NodeID id, Snapshot &snapshot) {
         return (*globalsFind).second;
     }
 
+    return this->getLocalSVFVarSet(id, snapshot);
+}
+
+/// @brief Find the value set of a non-global SVF variable. In sparse mode,
+/// this is the value last written by the variable's definition, regardless
+/// of the snapshot.
+ValueSet VSA::getLocalSVFVarSet(SVF::NodeID id, Snapshot &snapshot) {
+    if (this->sparse) {
+        return id < this->sparseVars.size() ? this->sparseVars[id].get()
+                                            : ValueSet();
+    }
+
     return snapshot.getSVFVarSet(id);
 }
 
+/// Whether a non-global SVF variable has been given a value yet
+bool VSA::hasLocalSVFVar(SVF::NodeID id, Snapshot &snapshot) {
+    if (this->sparse) {
+        return id < this->sparseDefined.size() && this->sparseDefined[id];
+    }
+
+    return snapshot.varState.find(id) != snapshot.varState.end();
+}
+
+/// @brief Set the value set of an SVF variable in the current block. In
+/// sparse mode the value goes straight into the table of SVF variables
+/// instead: SVF variables are in SSA form, so each one has exactly one
+/// definition, and that definition dominates every use of it. A use then
+/// reads the value from its definition directly (i.e. along the def-use
+/// edge), rather than from a copy carried through every snapshot in
+/// between.
+void VSA::setSVFVarSet(SVF::NodeID id, const ValueSet &vs) {
+    if (!this->sparse) {
+        this->blockState.varState[id] = vs;
+        return;
+    }
+
+    if (id >= this->sparseVars.size()) {
+        this->sparseVars.resize(id + 1);
+        this->sparseDefined.resize(id + 1, false);
+    }
+
+    this->sparseVars[id] = vs;
+    this->sparseDefined[id] = true;
+}
+
 /// @brief Implements `*(vs, s)` as defined in Balakrishnan, Reps (2004).
 /// Looks through `vs` and returns two sets of ALocs `F` and `P` - `F`
 /// represents all "fully accessed" ALocs (ones whose starting addresses are
@@ -246,40 +549,380 @@ VSA::getALocsByAccessSize(ValueSet vs, size_t s) {
     std::vector<ALoc> fullAccess;
     std::vector<ALoc> partialAccess;
 
-    for (auto kv : this->blockState.abstractStore.alocs) {
-        ALoc aloc = kv.first;
+    const ALocTable &table = this->alocTable;
+    const ALocStore &alocs = this->blockState.abstractStore.alocs;
+
+    for (auto entry : vs.values) {
+        RIC ric = entry.second;
+
+        // Only a-locs sharing a byte with the range of `vs` can be accessed
+        for (ALocID id : table.getIndex().overlapping(entry.first, ric)) {
+            if (!alocs.contains(id)) {
+                continue;
+            }
+
+            ALoc aloc = table.lookup(id);
+            bool alocInValueSet = aloc.in(ric);
+            bool alocStartInValueSet = ric.contains(aloc.offset);
+
+            if (alocStartInValueSet && aloc.size == s) {
+                fullAccess.push_back(aloc);
+            } else if (alocStartInValueSet || alocInValueSet) {
+                partialAccess.push_back(aloc);
+            }
+        }
+    }
+
+    return std::pair(fullAccess, partialAccess);
+}
+
+/// @brief Precompute everything the analysis needs to know about the shape
+/// of the ICFG: the successors of every node (see `getNextNodes`), which
+/// nodes start and end basic blocks, and the exits of every cycle. The
+/// analysis then walks the ICFG without copying statement lists or
+/// allocating.
+void VSA::initNodeLayout() {
+    SVF::NodeID nodeNum = this->icfg->getTotalNodeNum();
+    for (const auto &item : *this->icfg) {
+        nodeNum = std::max(nodeNum, item.first + 1);
+    }
 
-        auto vsRegion = vs.values.find(aloc.region);
-        if (vsRegion == vs.values.end()) {
+    std::vector<const SVF::ICFGNode *> nodes(nodeNum, nullptr);
+    for (const auto &item : *this->icfg) {
+        nodes[item.first] = item.second;
+    }
+
+    // Successors are stored back to back in node ID order, and nodes whose
+    // first statement is a branch are flagged as ending a block
+    this->nodeFlags.assign(nodeNum, 0);
+    this->successorStart.assign(nodeNum + 1, 0);
+    this->successors.clear();
+
+    for (SVF::NodeID id = 0; id < nodeNum; id++) {
+        this->successorStart[id] = this->successors.size();
+
+        if (const SVF::ICFGNode *node = nodes[id]) {
+            this->findNextNodes(node, this->successors);
+
+            const auto &stmts = node->getSVFStmts();
+            if (!stmts.empty() &&
+                SVF::SVFUtil::isa<SVF::BranchStmt>(stmts.front())) {
+                this->nodeFlags[id] |= ENDS_BLOCK;
+            }
+        }
+    }
+
+    this->successorStart[nodeNum] = this->successors.size();
+
+    // We only care about starts of basic blocks, i.e. nodes that only come
+    // from branch statements
+    for (const SVF::ICFGNode *node : nodes) {
+        if (!node) {
             continue;
         }
 
-        bool alocInValueSet = aloc.in((*vsRegion).second);
-        bool alocStartInValueSet = (*vsRegion).second.contains(aloc.offset);
+        bool startsBlock = true;
+        for (auto &edge : node->getInEdges()) {
+            if (!(this->nodeFlags[edge->getSrcNode()->getId()] & ENDS_BLOCK)) {
+                startsBlock = false;
+                break;
+            }
+        }
 
-        if (alocStartInValueSet && aloc.size == s) {
-            fullAccess.push_back(aloc);
-        } else if (alocStartInValueSet || alocInValueSet) {
-            partialAccess.push_back(aloc);
+        if (startsBlock) {
+            this->nodeFlags[node->getId()] |= STARTS_BLOCK;
         }
     }
 
-    return std::pair(fullAccess, partialAccess);
+    // Blocks that run into the function exit, which needs the successors
+    // and block starts above
+    for (const SVF::ICFGNode *node : nodes) {
+        if (node && (this->nodeFlags[node->getId()] & STARTS_BLOCK) &&
+            this->reachesFunExit(node)) {
+            this->nodeFlags[node->getId()] |= STARTS_RET_BLOCK;
+        }
+    }
+
+    for (const auto &item : this->cycleHeadToCycle) {
+        std::vector<const SVF::ICFGNode *> &exits =
+            this->cycleExits[item.second];
+        exits.clear();
+        this->findNextNodesOfCycle(item.second, exits);
+
+        // Nodes inside cycles are handled one at a time by
+        // `handleICFGCycle`, so they are never folded into superblocks
+        markCycleNodes(item.second, this->nodeFlags, IN_CYCLE);
+    }
+
+    // Fold straight-line chains of nodes into superblocks. A node continues
+    // into its successor if that is its only successor, the node is that
+    // successor's only predecessor, and the successor doesn't start a
+    // basic block - so both always run together, with nothing to merge in
+    // between.
+    std::vector<bool> continued(nodeNum, false);
+
+    for (const SVF::ICFGNode *node : nodes) {
+        if (!node || this->hasNodeFlag(node, IN_CYCLE)) {
+            continue;
+        }
+
+        NodeSpan nextNodes = this->getNextNodes(node);
+        if (nextNodes.size() != 1) {
+            continue;
+        }
+
+        const SVF::ICFGNode *next = nextNodes[0];
+        if (next == node || next->getInEdges().size() != 1 ||
+            (*next->getInEdges().begin())->getSrcNode() != node ||
+            this->hasNodeFlag(next, IN_CYCLE | STARTS_BLOCK)) {
+            continue;
+        }
+
+        this->nodeFlags[node->getId()] |= CONTINUES_SUPERBLOCK;
+        continued[next->getId()] = true;
+    }
+
+    // Every node of a superblock records the superblock's last node
+    this->superblockEnds.assign(nodeNum, nullptr);
+
+    for (const SVF::ICFGNode *node : nodes) {
+        if (!node || continued[node->getId()] ||
+            !this->hasNodeFlag(node, CONTINUES_SUPERBLOCK)) {
+            continue;
+        }
+
+        const SVF::ICFGNode *end = node;
+        while (this->hasNodeFlag(end, CONTINUES_SUPERBLOCK)) {
+            end = this->getNextNodes(end)[0];
+        }
+
+        for (const SVF::ICFGNode *member = node; member != end;
+             member = this->getNextNodes(member)[0]) {
+            this->superblockEnds[member->getId()] = end;
+        }
+
+        this->superblockEnds[end->getId()] = end;
+    }
+}
+
+/// @brief The constant indices of a GEP, including the leading index of
+/// the pointer itself.
+/// @return false if any index isn't a constant
+static bool getFieldPath(const SVF::GepStmt *gep,
+                         std::vector<int64_t> &path) {
+    for (const auto &pair : gep->getAccessPath().getIdxOperandPairVec()) {
+        auto index = SVF::SVFUtil::dyn_cast<SVF::ConstIntValVar>(pair.first);
+        if (!index) {
+            return false;
+        }
+
+        path.push_back(index->getSExtValue());
+    }
+
+    return true;
+}
+
+/// @brief Classify every SVF variable by what it refers to as the pointer
+/// of a load or store (see `VarRole`), so that decoding a load or store is
+/// one index into `varRoles` rather than a string comparison.
+///
+/// Registers are classified from the structure of the bitcode, so that
+/// stripped bitcode is handled the same as bitcode with names:
+/// - Every lifted function takes the `%struct.State` pointer as its first
+///   argument. GEPs off it are classified by their field path (see
+///   `VarRole::fromStatePath`), and take their width from each access
+///   (see `lowerLocation`).
+/// - Casts of a register's pointer are the same register, as is byte 1 of
+///   one (e.g. AH).
+///
+/// `NEXT_PC` and `RETURN_PC` are the allocas with those names. Without
+/// names, `NEXT_PC` is the alloca that the program counter (the second
+/// argument) is stored to, and `RETURN_PC` is the second alloca of the
+/// function, since Remill allocates `BRANCH_TAKEN`, `RETURN_PC` and
+/// `MONITOR` first, in that order.
+///
+/// Remill's register names are then used to cross-check the registers,
+/// which catches bitcode with a different `State` layout.
+void VSA::initVarRoles() {
+    SVF::NodeID varNum = this->svfir->getTotalNodeNum();
+    for (const auto &item : *this->svfir) {
+        varNum = std::max(varNum, item.first + 1);
+    }
+
+    this->varRoles.assign(varNum, VarRole());
+
+    auto isArgument = [](const SVF::SVFVar *var, SVF::u32_t argNo) {
+        auto arg = SVF::SVFUtil::dyn_cast<SVF::ArgValVar>(var);
+        return arg && arg->getArgNo() == argNo;
+    };
+
+    // Registers and the PC, from GEPs off the state pointer
+    for (const SVF::SVFStmt *stmt :
+         this->svfir->getSVFStmtSet(SVF::SVFStmt::Gep)) {
+        auto gep = SVF::SVFUtil::dyn_cast<SVF::GepStmt>(stmt);
+        if (!gep || !isArgument(gep->getRHSVar(), 0)) {
+            continue;
+        }
+
+        std::vector<int64_t> path;
+        if (getFieldPath(gep, path)) {
+            this->varRoles[gep->getLHSVarID()] = VarRole::fromStatePath(path);
+        }
+    }
+
+    // Casts of registers and GEPs to their high byte. Casts can be chained,
+    // so repeat until nothing changes.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (const SVF::SVFStmt *stmt :
+             this->svfir->getSVFStmtSet(SVF::SVFStmt::Copy)) {
+            auto copy = SVF::SVFUtil::dyn_cast<SVF::CopyStmt>(stmt);
+            VarRole role = this->varRoles[copy->getRHSVarID()];
+            VarRole &cast = this->varRoles[copy->getLHSVarID()];
+
+            if (!role.alias.isRegister() ||
+                cast.location != Location::Other) {
+                continue;
+            }
+
+            cast = role;
+            changed = true;
+        }
+
+        for (const SVF::SVFStmt *stmt :
+             this->svfir->getSVFStmtSet(SVF::SVFStmt::Gep)) {
+            auto gep = SVF::SVFUtil::dyn_cast<SVF::GepStmt>(stmt);
+            VarRole role = this->varRoles[gep->getRHSVarID()];
+            VarRole &field = this->varRoles[gep->getLHSVarID()];
+
+            // `{ low, high }` is the only struct in a register
+            std::vector<int64_t> path;
+            if (role.alias.shift != 0 || !role.alias.isRegister() ||
+                field.location != Location::Other ||
+                !getFieldPath(gep, path) || path.size() != 2 ||
+                path[0] != 0 || path[1] < 0 || path[1] > 1) {
+                continue;
+            }
+
+            field = role;
+            field.alias.shift = (uint8_t)path[1];
+            changed = true;
+        }
+    }
+
+    // `NEXT_PC` and `RETURN_PC`, by name where the bitcode has names
+    SVF::Set<const SVF::FunObjVar *> namedNextPc, namedReturnPc;
+
+    for (const auto &item : *this->svfir) {
+        if (!SVF::SVFUtil::isa<SVF::ValVar>(item.second)) {
+            continue;
+        }
+
+        VarRole named = VarRole::fromName(item.second->getName());
+        if (named.location == Location::NextPC) {
+            namedNextPc.insert(item.second->getFunction());
+        } else if (named.location == Location::ReturnPC) {
+            namedReturnPc.insert(item.second->getFunction());
+        } else {
+            continue;
+        }
+
+        this->varRoles[item.first] = named;
+    }
+
+    // Otherwise `NEXT_PC` is the alloca the program counter is stored to
+    SVF::Set<const SVF::FunObjVar *> liftedFuns;
+
+    for (const SVF::SVFStmt *stmt :
+         this->svfir->getSVFStmtSet(SVF::SVFStmt::Store)) {
+        auto store = SVF::SVFUtil::dyn_cast<SVF::StoreStmt>(stmt);
+        if (!isArgument(store->getRHSVar(), 1)) {
+            continue;
+        }
+
+        const SVF::FunObjVar *fun = store->getLHSVar()->getFunction();
+        liftedFuns.insert(fun);
+
+        if (!namedNextPc.count(fun)) {
+            this->varRoles[store->getLHSVarID()].location = Location::NextPC;
+        }
+    }
+
+    // and `RETURN_PC` is the second alloca of a lifted function. Variables
+    // are numbered in the order of their instructions.
+    SVF::Map<const SVF::FunObjVar *, std::vector<SVF::NodeID>> allocas;
+
+    for (const SVF::SVFStmt *stmt :
+         this->svfir->getSVFStmtSet(SVF::SVFStmt::Addr)) {
+        auto addr = SVF::SVFUtil::dyn_cast<SVF::AddrStmt>(stmt);
+        if (!SVF::SVFUtil::isa<SVF::StackObjVar>(addr->getRHSVar())) {
+            continue;
+        }
+
+        const SVF::FunObjVar *fun = addr->getLHSVar()->getFunction();
+        if (liftedFuns.count(fun) && !namedReturnPc.count(fun)) {
+            allocas[fun].push_back(addr->getLHSVarID());
+        }
+    }
+
+    for (auto &item : allocas) {
+        std::vector<SVF::NodeID> &ids = item.second;
+        std::sort(ids.begin(), ids.end());
+
+        if (ids.size() > 1 &&
+            this->varRoles[ids[1]].location == Location::Other) {
+            this->varRoles[ids[1]].location = Location::ReturnPC;
+        }
+    }
+
+    // Cross-check registers against Remill's names, where the bitcode still
+    // has them
+    size_t mismatches = 0;
+
+    for (const auto &item : *this->svfir) {
+        if (!SVF::SVFUtil::isa<SVF::ValVar>(item.second)) {
+            continue;
+        }
+
+        VarRole named = VarRole::fromName(item.second->getName());
+        if (named.location != Location::Other &&
+            !this->varRoles[item.first].agreesWith(named)) {
+            mismatches++;
+        }
+    }
+
+    if (mismatches != 0) {
+        SVF::SVFUtil::errs()
+            << mismatches << " variables have a role that doesn't match "
+            << "their Remill name - is the State layout different?\n";
+    }
+}
+
+/// @brief Get the last node of the superblock holding a node - the node
+/// itself if it isn't part of a longer superblock.
+const SVF::ICFGNode *
+VSA::getSuperblockEnd(const SVF::ICFGNode *node) const {
+    SVF::NodeID id = node->getId();
+    if (id < this->superblockEnds.size() && this->superblockEnds[id]) {
+        return this->superblockEnds[id];
+    }
+
+    return node;
 }
 
 /**
- * @brief Get the next nodes of a node
+ * @brief Find the next nodes of a node
  *
- * Returns the next nodes of a node that are inside the same function.
+ * Finds the next nodes of a node that are inside the same function.
  * And if CallICFGNode, shortcut to the RetICFGNode.
  *
- * @param node The node to get the next nodes of
- * @return The next nodes of the node
+ * @param node The node to find the next nodes of
+ * @param outEdges The list that the next nodes are appended to
  */
-std::vector<const SVF::ICFGNode *>
-VSA::getNextNodes(const SVF::ICFGNode *node) const {
-    std::vector<const SVF::ICFGNode *> outEdges;
-
+void VSA::findNextNodes(const SVF::ICFGNode *node,
+                        std::vector<const SVF::ICFGNode *> &outEdges) const {
     for (const SVF::ICFGEdge *edge : node->getOutEdges()) {
         const SVF::ICFGNode *dst = edge->getDstNode();
         // Only nodes inside the same function are included
@@ -294,23 +937,22 @@ VSA::getNextNodes(const SVF::ICFGNode *node) const {
         const SVF::ICFGNode *retNode = callNode->getRetICFGNode();
         outEdges.push_back(retNode);
     }
-
-    return outEdges;
 }
 
 /**
- * @brief Get the next nodes of a cycle
+ * @brief Find the next nodes of a cycle
  *
- * Returns the next nodes of cycle components that are outside the cycle.
+ * Finds the next nodes of cycle components that are outside the cycle.
  * Inner cycles are skipped since their next nodes cannot be outside the outer
  * cycle. And Inner cycles are handled in the outer cycle. Only nodes that point
  * outside the cycle are included in cycleNext.
  *
- * @param cycle The cycle to get the next nodes of
- * @return The next nodes of the cycle
+ * @param cycle The cycle to find the next nodes of
+ * @param outEdges The list that the next nodes are appended to
  */
-std::vector<const SVF::ICFGNode *>
-VSA::getNextNodesOfCycle(const SVF::ICFGCycleWTO *cycle) const {
+void VSA::findNextNodesOfCycle(
+    const SVF::ICFGCycleWTO *cycle,
+    std::vector<const SVF::ICFGNode *> &outEdges) const {
     SVF::Set<const SVF::ICFGNode *> cycleNodes;
 
     // Insert the head of the cycle and the heads of the inner cycles
@@ -326,11 +968,8 @@ VSA::getNextNodesOfCycle(const SVF::ICFGCycleWTO *cycle) const {
         }
     }
 
-    std::vector<const SVF::ICFGNode *> outEdges;
-    std::vector<const SVF::ICFGNode *> nextNodes =
-        getNextNodes(cycle->head()->getICFGNode());
-
-    for (const SVF::ICFGNode *nextNode : nextNodes) {
+    for (const SVF::ICFGNode *nextNode :
+         getNextNodes(cycle->head()->getICFGNode())) {
         // Only nodes that point outside the cycle are included
         if (cycleNodes.find(nextNode) == cycleNodes.end()) {
             outEdges.push_back(nextNode);
@@ -340,11 +979,9 @@ VSA::getNextNodesOfCycle(const SVF::ICFGCycleWTO *cycle) const {
     for (const SVF::ICFGWTOComp *comp : cycle->getWTOComponents()) {
         if (const SVF::ICFGSingletonWTO *singleton =
                 SVF::SVFUtil::dyn_cast<SVF::ICFGSingletonWTO>(comp)) {
-            std::vector<const SVF::ICFGNode *> nextNodes =
-                getNextNodes(singleton->getICFGNode());
-
             // Only nodes that point outside the cycle are included
-            for (const SVF::ICFGNode *nextNode : nextNodes) {
+            for (const SVF::ICFGNode *nextNode :
+                 getNextNodes(singleton->getICFGNode())) {
                 if (cycleNodes.find(nextNode) == cycleNodes.end()) {
                     outEdges.push_back(nextNode);
                 }
@@ -357,8 +994,31 @@ VSA::getNextNodesOfCycle(const SVF::ICFGCycleWTO *cycle) const {
             continue;
         }
     }
+}
+
+/// @brief Get the next nodes of a node inside the same function (see
+/// `findNextNodes`), as precomputed by `initNodeLayout`.
+NodeSpan VSA::getNextNodes(const SVF::ICFGNode *node) const {
+    SVF::NodeID id = node->getId();
+    if (id + 1 >= this->successorStart.size()) {
+        return NodeSpan();
+    }
 
-    return outEdges;
+    const SVF::ICFGNode *const *first = this->successors.data();
+    return NodeSpan(first + this->successorStart[id],
+                    first + this->successorStart[id + 1]);
+}
+
+/// @brief Get the next nodes of a cycle outside the cycle (see
+/// `findNextNodesOfCycle`), as precomputed by `initNodeLayout`.
+NodeSpan VSA::getNextNodesOfCycle(const SVF::ICFGCycleWTO *cycle) const {
+    auto it = this->cycleExits.find(cycle);
+    if (it == this->cycleExits.end()) {
+        return NodeSpan();
+    }
+
+    const std::vector<const SVF::ICFGNode *> &exits = it->second;
+    return NodeSpan(exits.data(), exits.data() + exits.size());
 }
 
 /**
@@ -388,18 +1048,21 @@ bool VSA::mergeStatesFromPredecessors(const SVF::ICFGNode *node,
     for (auto &edge : node->getInEdges()) {
         // Check if the source node of the edge has a post-execution state
         // recorded
-        if (this->postBasicBlock.find(edge->getSrcNode()) !=
-            this->postBasicBlock.end()) {
-            Snapshot temp = this->postBasicBlock[edge->getSrcNode()];
+        if (Snapshot *post = this->postBasicBlock.find(
+                this->getBlockId(edge->getSrcNode()))) {
             // Regardless of whether the branch is feasible or not, the
             // `NEXT_PC` has to be the same
-            this->nextPc = temp.nextPc;
+            this->nextPc = post->nextPc;
 
             const SVF::IntraCFGEdge *intraCfgEdge =
                 SVF::SVFUtil::dyn_cast<SVF::IntraCFGEdge>(edge);
 
             // If the edge is an intra-block edge and has a condition
             if (intraCfgEdge && intraCfgEdge->getCondition()) {
+                // Only a conditional edge refines the predecessor's state,
+                // so only copy it here
+                Snapshot temp = *post;
+
                 // Check if the branch condition is feasible
                 if (isBranchFeasible(intraCfgEdge, temp)) {
                     // Merge the state with the current state
@@ -409,8 +1072,7 @@ bool VSA::mergeStatesFromPredecessors(const SVF::ICFGNode *node,
                 // If branch is not feasible, do nothing
             } else {
                 // For non-conditional edges, directly merge the state
-                as.joinWith(
-                    this->postBasicBlock[edge->getSrcNode()].abstractStore);
+                as.joinWith(post->abstractStore);
                 inEdgeNum++;
             }
         }
@@ -466,9 +1128,9 @@ bool VSA::isCmpBranchFeasible(const SVF::CmpStmt *cmpStmt, SVF::s64_t succ,
     // if op0 or op1 is undefined, return;
     // skip address compare
     if ((this->globalState.find(op0) == this->globalState.end() &&
-         newVarState.find(op0) == newVarState.end()) ||
+         !this->hasLocalSVFVar(op0, snapshot)) ||
         (this->globalState.find(op1) == this->globalState.end() &&
-         newVarState.find(op1) == newVarState.end())) {
+         !this->hasLocalSVFVar(op1, snapshot))) {
         snapshot.varState = newVarState;
         return true;
     }
@@ -507,7 +1169,8 @@ bool VSA::isCmpBranchFeasible(const SVF::CmpStmt *cmpStmt, SVF::s64_t succ,
     // for var X const, we may get [0,1] if the intersection of var and const is
     // not empty set
 
-    RIC resVal = newVarState[res_id].getGlobal();
+    ValueSet resSet = this->getLocalSVFVarSet(res_id, snapshot);
+    RIC resVal = resSet.getGlobal();
     RIC succRic(succ);
     resVal.meetWith(succRic);
 
@@ -517,13 +1180,13 @@ bool VSA::isCmpBranchFeasible(const SVF::CmpStmt *cmpStmt, SVF::s64_t succ,
         return false;
     }
 
-    ValueSet op0vs = newVarState[op0];
+    ValueSet op0vs = this->getLocalSVFVarSet(op0, snapshot);
 
     ValueSet op1vs;
     if (this->globalState.find(op1) != this->globalState.end()) {
         op1vs = this->globalState[op1];
     } else {
-        op1vs = newVarState[op1];
+        op1vs = this->getLocalSVFVarSet(op1, snapshot);
     }
 
     bool b0 = op0vs.getGlobal().isConstant();
@@ -583,7 +1246,7 @@ bool VSA::isCmpBranchFeasible(const SVF::CmpStmt *cmpStmt, SVF::s64_t succ,
     case SVF::CmpStmt::Predicate::FCMP_OGT:
     case SVF::CmpStmt::Predicate::FCMP_UGT: {
         // Var > Const, so [var.lb, var.ub].meet_with([Const+1, +INF])
-        RIC meetValue(1, rhs.lower() + 1, SVF::BoundedInt::plus_infinity(), 0);
+        RIC meetValue(1, rhs.lower() + 1, Bound::plus_infinity(), 0);
         lhs.meetWith(meetValue);
         break;
     }
@@ -611,7 +1274,7 @@ bool VSA::isCmpBranchFeasible(const SVF::CmpStmt *cmpStmt, SVF::s64_t succ,
     case SVF::CmpStmt::Predicate::FCMP_OLE:
     case SVF::CmpStmt::Predicate::FCMP_ULE: {
         // Var <= Const, so [var.lb, var.ub].meet_with([-INF, const.ub])
-        RIC meetValue(1, SVF::BoundedInt::minus_infinity(), rhs.upper(), 0);
+        RIC meetValue(1, Bound::minus_infinity(), rhs.upper(), 0);
         lhs.meetWith(meetValue);
         break;
     }
@@ -627,7 +1290,9 @@ bool VSA::isCmpBranchFeasible(const SVF::CmpStmt *cmpStmt, SVF::s64_t succ,
     }
 
     // Update variable
-    newVarState[op0].values[0] = lhs;
+    ValueSet op0Set = this->getLocalSVFVarSet(op0, snapshot);
+    op0Set.values[0] = lhs;
+    newVarState[op0] = op0Set;
 
     /*
     for (const auto &addr : addrs) {
@@ -701,49 +1366,42 @@ bool VSA::isCmpBranchFeasible(const SVF::CmpStmt *cmpStmt, SVF::s64_t succ,
     // Value of node was retrieved from call function
     if (const SVF::CallICFGNode *callNode =
             SVF::SVFUtil::dyn_cast<SVF::CallICFGNode>(op0Var->getICFGNode())) {
-        size_t size =
-            READ_FNS_TO_SIZES.at(callNode->getCalledFunction()->getName());
+        const Intrinsic *read = IntrinsicTable::getTable().lookup(
+            callNode->getCalledFunction()->getName());
+        assert(read && read->kind == CallKind::MemoryRead &&
+               "compared value not read from memory");
+        size_t size = read->size;
 
         SVF::NodeID addrId = callNode->getArgument(1)->getId();
-        ValueSet addrValueSet = snapshot.getSVFVarSet(addrId);
+        ValueSet addrValueSet = this->getLocalSVFVarSet(addrId, snapshot);
 
         // TODO: change region when implementing interprocedural VSA
         ALoc aloc{1, addrValueSet.values[1].getConstant(), size};
-        snapshot.abstractStore.alocs[aloc].values[0] = lhs;
+        ALocID id = this->alocTable.intern(aloc);
+        ValueSet alocSet = snapshot.abstractStore.alocs[id];
+        alocSet.values[0] = lhs;
+        snapshot.abstractStore.alocs[id] = alocSet;
     }
 
     snapshot.varState = newVarState;
     return true;
 }
 
-bool VSA::isStartOfBasicBlock(const SVF::ICFGNode *node) {
-    for (auto &edge : node->getInEdges()) {
-        auto srcNode = edge->getSrcNode();
-        auto srcStmts = srcNode->getSVFStmts();
-
-        if (srcStmts.empty()) {
-            return false;
-        }
-
-        // We only care about starts of basic blocks, i.e. nodes that
-        // come from branch statements.
-        if (!SVF::SVFUtil::isa<SVF::BranchStmt>(srcStmts.front())) {
-            return false;
-        }
-    }
-
-    return true;
+bool VSA::isStartOfBasicBlock(const SVF::ICFGNode *node) const {
+    return this->hasNodeFlag(node, STARTS_BLOCK);
 }
 
-bool VSA::isStartOfRetBlock(const SVF::ICFGNode *node) {
-    if (!isStartOfBasicBlock(node)) {
-        return false;
-    }
+bool VSA::isStartOfRetBlock(const SVF::ICFGNode *node) const {
+    return this->hasNodeFlag(node, STARTS_RET_BLOCK);
+}
 
+/// @brief Whether the block starting at a node runs into the exit of its
+/// function, rather than ending in a branch.
+bool VSA::reachesFunExit(const SVF::ICFGNode *node) const {
     const SVF::ICFGNode *check = node;
 
     while (true) {
-        auto nextNodes = getNextNodes(check);
+        NodeSpan nextNodes = getNextNodes(check);
 
         if (nextNodes.size() != 1 &&
             !SVF::SVFUtil::isa<SVF::CallICFGNode>(check)) {
@@ -759,12 +1417,7 @@ bool VSA::isStartOfRetBlock(const SVF::ICFGNode *node) {
             return true;
         }
 
-        auto stmts = check->getSVFStmts();
-        if (stmts.empty()) {
-            continue;
-        }
-
-        if (SVF::SVFUtil::isa<SVF::BranchStmt>(stmts.front())) {
+        if (this->hasNodeFlag(check, ENDS_BLOCK)) {
             break;
         }
     }
@@ -772,18 +1425,14 @@ bool VSA::isStartOfRetBlock(const SVF::ICFGNode *node) {
     return false;
 }
 
-const SVF::ICFGNode *VSA::getBlockEnd(const SVF::ICFGNode *start) {
+const SVF::ICFGNode *VSA::getBlockEnd(const SVF::ICFGNode *start) const {
     const SVF::ICFGNode *blockEnd = start;
 
+    // A branch always ends its superblock, so whole superblocks can be
+    // stepped over at once
     while (true) {
-        auto stmts = blockEnd->getSVFStmts();
-        if (stmts.empty()) {
-            blockEnd = getNextNodes(blockEnd)[0];
-            continue;
-        }
-
-        auto stmt = blockEnd->getSVFStmts().front();
-        if (stmt->getEdgeKind() == SVF::SVFStmt::Branch) {
+        blockEnd = this->getSuperblockEnd(blockEnd);
+        if (this->hasNodeFlag(blockEnd, ENDS_BLOCK)) {
             break;
         }
 
@@ -793,20 +1442,14 @@ const SVF::ICFGNode *VSA::getBlockEnd(const SVF::ICFGNode *start) {
     return blockEnd;
 }
 
-const SVF::ICFGNode *VSA::skipBlocks(const SVF::ICFGNode *start, size_t n) {
+const SVF::ICFGNode *VSA::skipBlocks(const SVF::ICFGNode *start,
+                                     size_t n) const {
     const SVF::ICFGNode *pastSkippedBlocks = start;
     size_t skippedBlocks = 0;
 
     while (skippedBlocks < n) {
-        auto stmts = pastSkippedBlocks->getSVFStmts();
-        if (stmts.empty()) {
-            pastSkippedBlocks = getNextNodes(pastSkippedBlocks)[0];
-            continue;
-        }
-
-        auto stmt = pastSkippedBlocks->getSVFStmts().front();
-
-        if (stmt->getEdgeKind() == SVF::SVFStmt::Branch) {
+        pastSkippedBlocks = this->getSuperblockEnd(pastSkippedBlocks);
+        if (this->hasNodeFlag(pastSkippedBlocks, ENDS_BLOCK)) {
             skippedBlocks++;
         }
 
@@ -876,12 +1519,15 @@ void VSA::handleFunction(const SVF::ICFGNode *funEntry) {
     const SVF::ICFGNode *endPrevBlock = getBlockEnd(pastSkippedBlocks);
 
     Snapshot snapshot = this->blockState;
-    this->postBasicBlock.insert({endPrevBlock, snapshot});
+    BlockID endPrevBlockId = this->getBlockId(endPrevBlock);
+    if (!this->postBasicBlock.contains(endPrevBlockId)) {
+        this->postBasicBlock[endPrevBlockId] = snapshot;
+    }
 
     pastSkippedBlocks = getNextNodes(endPrevBlock)[0];
 
     // Begin function analysis
-    SVF::FIFOWorkList<const SVF::ICFGNode *> worklist;
+    WTOWorkList worklist(this->wtoOrder);
     worklist.push(pastSkippedBlocks);
 
     while (!worklist.empty()) {
@@ -892,11 +1538,10 @@ void VSA::handleFunction(const SVF::ICFGNode *funEntry) {
             const SVF::ICFGCycleWTO *cycle = this->cycleHeadToCycle[node];
             handleICFGCycle(cycle);
 
-            std::vector<const SVF::ICFGNode *> cycleNextNodes =
-                getNextNodesOfCycle(cycle);
-
-            for (const SVF::ICFGNode *nextNode : cycleNextNodes) {
-                worklist.push(nextNode);
+            for (const SVF::ICFGNode *nextNode : getNextNodesOfCycle(cycle)) {
+                if (this->isInSlice(nextNode)) {
+                    worklist.push(nextNode);
+                }
             }
         } else {
             if (isStartOfRetBlock(node)) {
@@ -910,10 +1555,12 @@ void VSA::handleFunction(const SVF::ICFGNode *funEntry) {
                 continue;
             }
 
-            std::vector<const SVF::ICFGNode *> nextNodes = getNextNodes(node);
-
-            for (const SVF::ICFGNode *nextNode : nextNodes) {
-                worklist.push(nextNode);
+            // The rest of the superblock was handled along with `node`
+            for (const SVF::ICFGNode *nextNode :
+                 getNextNodes(getSuperblockEnd(node))) {
+                if (this->isInSlice(nextNode)) {
+                    worklist.push(nextNode);
+                }
             }
         }
     }
@@ -936,9 +1583,10 @@ void VSA::handleICFGCycle(const SVF::ICFGCycleWTO *cycle) {
 
     // Get execution states from in edges
     const SVF::ICFGNode *head = cycle->head()->getICFGNode();
+    BlockID headId = this->getBlockId(head);
 
     bool is_feasible = mergeStatesFromPredecessors(
-        head, this->preBasicBlock[head].abstractStore);
+        head, this->preBasicBlock[headId].abstractStore);
 
     if (!is_feasible) {
         return;
@@ -963,7 +1611,7 @@ void VSA::handleICFGCycle(const SVF::ICFGCycleWTO *cycle) {
             }
         }
 
-        AbstractStore preAs = this->preBasicBlock[head].abstractStore;
+        AbstractStore preAs = this->preBasicBlock[headId].abstractStore;
         bool increasing = true;
 
         // 2. Check if increasing - if so, then widen, if not repeat step 2
@@ -973,42 +1621,27 @@ void VSA::handleICFGCycle(const SVF::ICFGCycleWTO *cycle) {
             mergeStatesFromPredecessors(head, curAs);
 
             if (increasing) {
-                // We widen
-                AbstractStore widened = preAs;
-                widened.widenWith(curAs);
-                curAs = widened;
-
-                if (widened == preAs) {
-                    // We've reached a fixed point!
+                // We widen - if widening changes nothing, we've reached a
+                // fixed point!
+                if (!preAs.widenWith(curAs)) {
                     increasing = false;
                     this->narrowing = true;
                     continue;
                 }
             } else {
                 // We now narrow
-                AbstractStore narrowed = preAs;
-                narrowed.narrowWith(curAs);
-                curAs = narrowed;
-
-                if (narrowed == preAs) {
+                if (!preAs.narrowWith(curAs)) {
                     this->narrowing = false;
                     break;
                 }
             }
 
             // Handle head
-            this->preBasicBlock[head].abstractStore = curAs;
+            this->preBasicBlock[headId].abstractStore = preAs;
             this->blockState.abstractStore =
-                this->preBasicBlock[head].abstractStore;
-
-            for (const SVF::SVFStmt *stmt : head->getSVFStmts()) {
-                updateAbsState(stmt);
-            }
+                this->preBasicBlock[headId].abstractStore;
 
-            if (const SVF::CallICFGNode *callNode =
-                    SVF::SVFUtil::dyn_cast<SVF::CallICFGNode>(head)) {
-                handleCallSite(callNode);
-            }
+            this->runNode(head);
 
             // Handle all other nodes in cycle
             for (auto comp : cycle->getWTOComponents()) {
@@ -1021,8 +1654,6 @@ void VSA::handleICFGCycle(const SVF::ICFGCycleWTO *cycle) {
                         SVF::SVFUtil::dyn_cast<SVF::ICFGCycleWTO>(comp));
                 }
             }
-
-            preAs = curAs;
         }
     }
 
@@ -1030,11 +1661,13 @@ void VSA::handleICFGCycle(const SVF::ICFGCycleWTO *cycle) {
 }
 
 /**
- * @brief Handle a node in the ICFG
+ * @brief Handle a node in the ICFG, along with the rest of its superblock
  *
  * This function handles a node in the ICFG by merging the abstract states of
  * its predecessors, updating the abstract state based on the node's statements,
- * and handling stub functions. It also checks if the abstract state has reached
+ * and handling stub functions. Every later node of the node's superblock is
+ * then updated in turn, since they always run straight after it (see
+ * `initNodeLayout`). It also checks if the abstract state has reached
  * a fixpoint and returns the result. Return true means the abstract state has
  * changed Return false means the abstract state has reached a fixpoint or is
  * infeasible
@@ -1043,6 +1676,8 @@ void VSA::handleICFGCycle(const SVF::ICFGCycleWTO *cycle) {
  * @return True if it is feasible, false if it is infeasible
  */
 bool VSA::handleICFGNode(const SVF::ICFGNode *node) {
+    this->nodeVisits++;
+
     bool isStart = isStartOfBasicBlock(node);
 
     if (isStart) {
@@ -1055,36 +1690,27 @@ bool VSA::handleICFGNode(const SVF::ICFGNode *node) {
             return false;
         }
 
-        this->preBasicBlock[node].abstractStore = tmpEs;
-        this->blockState.abstractStore =
-            this->preBasicBlock[node].abstractStore;
+        Snapshot &pre = this->preBasicBlock[this->getBlockId(node)];
+        pre.abstractStore = tmpEs;
+        this->blockState.abstractStore = pre.abstractStore;
+    }
 
-        for (const SVF::SVFStmt *stmt : node->getSVFStmts()) {
-            updateAbsState(stmt);
-        }
+    // Past the start of a basic block, the abstract state
+    // updating/fixpoint-checking doesn't apply, so the rest of the
+    // superblock just runs its statements
+    this->runNode(node);
 
-        if (const SVF::CallICFGNode *callNode =
-                SVF::SVFUtil::dyn_cast<SVF::CallICFGNode>(node)) {
-            handleCallSite(callNode);
-        }
-    } else {
-        // If we're not in the start of a basic block, then the abstract
-        // state updating/fixpoint-checking doesn't apply
-        for (const SVF::SVFStmt *stmt : node->getSVFStmts()) {
-            updateAbsState(stmt);
-        }
-
-        if (const SVF::CallICFGNode *callNode =
-                SVF::SVFUtil::dyn_cast<SVF::CallICFGNode>(node)) {
-            handleCallSite(callNode);
-        }
+    while (this->hasNodeFlag(node, CONTINUES_SUPERBLOCK)) {
+        node = this->getNextNodes(node)[0];
+        this->runNode(node);
     }
 
     return true;
 }
 
 void VSA::handleRemillRead(SVF::NodeID retId, SVF::NodeID addrId, size_t size) {
-    ValueSet addrValueSet = this->blockState.getSVFVarSet(addrId);
+    ValueSet addrValueSet =
+        this->getLocalSVFVarSet(addrId, this->blockState);
     auto alocs = getALocsByAccessSize(addrValueSet, size);
     std::vector<ALoc> fullAccesses = alocs.first;
     std::vector<ALoc> partialAccesses = alocs.second;
@@ -1093,20 +1719,23 @@ void VSA::handleRemillRead(SVF::NodeID retId, SVF::NodeID addrId, size_t size) {
         ValueSet newRetSet;
 
         for (ALoc aloc : fullAccesses) {
-            ValueSet alocValueSet = this->blockState.getALocSet(aloc);
+            ValueSet alocValueSet =
+                this->blockState.getALocSet(aloc, this->alocTable);
             newRetSet.joinWith(alocValueSet);
         }
 
-        this->blockState.varState[retId] = newRetSet;
+        this->setSVFVarSet(retId, newRetSet);
     } else {
-        this->blockState.varState[retId].top = true;
-        this->blockState.varState[retId].values.clear();
+        ValueSet top;
+        top.top = true;
+        this->setSVFVarSet(retId, top);
     }
 }
 
 void VSA::handleRemillWrite(SVF::NodeID addrId, SVF::NodeID valueId,
                             size_t size) {
-    ValueSet addrValueSet = this->blockState.getSVFVarSet(addrId);
+    ValueSet addrValueSet =
+        this->getLocalSVFVarSet(addrId, this->blockState);
     ValueSet valueValueSet = this->getSVFVarSet(valueId, this->blockState);
 
     auto alocs = getALocsByAccessSize(addrValueSet, size);
@@ -1118,28 +1747,31 @@ void VSA::handleRemillWrite(SVF::NodeID addrId, SVF::NodeID valueId,
 
     // Clear all (full + partial) accesses
     for (auto aloc : fullAccesses) {
-        tmp.alocs[aloc] = ValueSet();
+        tmp.alocs[this->alocTable.intern(aloc)] = ValueSet();
     }
 
+    ValueSet top;
+    top.top = true;
+
     for (auto aloc : partialAccesses) {
         // Replace partial accesses with TOP
-        tmp.alocs[aloc] = ValueSet();
-        tmp.alocs[aloc].top = true;
+        tmp.alocs[this->alocTable.intern(aloc)] = top;
     }
 
     if (fullAccesses.size() == 1 && partialAccesses.empty()) {
         // Strong update
         ALoc access = fullAccesses[0];
-        tmp.alocs[access] = valueValueSet;
+        tmp.alocs[this->alocTable.intern(access)] = valueValueSet;
     } else {
         // Weak update
         for (auto aloc : fullAccesses) {
-            auto alocValueSet = this->blockState.abstractStore.alocs.find(aloc);
-            if (alocValueSet == this->blockState.abstractStore.alocs.end()) {
+            const ALocStore &alocs = this->blockState.abstractStore.alocs;
+            auto alocValueSet = alocs.find(aloc, this->alocTable);
+            if (alocValueSet == alocs.end()) {
                 continue;
             }
 
-            tmp.alocs[aloc] = (*alocValueSet).second;
+            tmp.alocs[(*alocValueSet).id] = (*alocValueSet).second;
         }
     }
 
@@ -1147,7 +1779,7 @@ void VSA::handleRemillWrite(SVF::NodeID addrId, SVF::NodeID valueId,
 }
 
 void VSA::handleScanf(SVF::NodeID retId) {
-    ValueSet addrVs = this->blockState.getRegisterSet("RSI");
+    ValueSet addrVs = this->blockState.getRegisterSet(Register::RSI);
 
     auto alocs = getALocsByAccessSize(addrVs, 8);
     auto fullAccesses = alocs.first;
@@ -1158,30 +1790,31 @@ void VSA::handleScanf(SVF::NodeID retId) {
 
     // Clear all (full + partial) accesses
     for (auto aloc : fullAccesses) {
-        tmp.alocs[aloc] = ValueSet();
+        tmp.alocs[this->alocTable.intern(aloc)] = ValueSet();
     }
 
+    ValueSet top;
+    top.top = true;
+
     for (auto aloc : partialAccesses) {
         // Replace partial accesses with TOP
-        tmp.alocs[aloc] = ValueSet();
-        tmp.alocs[aloc].top = true;
+        tmp.alocs[this->alocTable.intern(aloc)] = top;
     }
 
     if (fullAccesses.size() == 1 && partialAccesses.empty()) {
         // Strong update
         ALoc access = fullAccesses[0];
-        ValueSet top;
-        top.top = true;
-        tmp.alocs[access] = top;
+        tmp.alocs[this->alocTable.intern(access)] = top;
     } else {
         // Weak update
         for (auto aloc : fullAccesses) {
-            auto alocValueSet = this->blockState.abstractStore.alocs.find(aloc);
-            if (alocValueSet == this->blockState.abstractStore.alocs.end()) {
+            const ALocStore &alocs = this->blockState.abstractStore.alocs;
+            auto alocValueSet = alocs.find(aloc, this->alocTable);
+            if (alocValueSet == alocs.end()) {
                 continue;
             }
 
-            tmp.alocs[aloc] = (*alocValueSet).second;
+            tmp.alocs[(*alocValueSet).id] = (*alocValueSet).second;
         }
     }
 
@@ -1193,175 +1826,400 @@ void VSA::handleScanf(SVF::NodeID retId) {
  *
  * This function processes a call site by updating the abstract state, handling
  * the called function, and managing the call stack. It resumes the execution
- * state after the function call.
+ * state after the function call. What the callee does was already resolved
+ * when the call was decoded (see `lowerCall`).
  *
- * @param node The call site node to be handled
+ * @param call The `CallSite` instruction of the call node
  */
-void VSA::handleCallSite(const SVF::CallICFGNode *callNode) {
-    // Get the callee function associated with the call site
-    const SVF::FunObjVar *callee = callNode->getCalledFunction();
-    std::string fun_name = callee->getName();
-
-    if (fun_name.rfind("__remill_read_memory", 0) == 0) {
-        SVF::NodeID retId = callNode->getRetICFGNode()->getActualRet()->getId();
-        SVF::NodeID addrId = callNode->getArgument(1)->getId();
-        size_t size = READ_FNS_TO_SIZES.at(fun_name);
+void VSA::handleCallSite(const Instruction &call) {
+    const SVF::CallICFGNode *callNode = call.call;
 
+    switch (call.callee) {
+    case CallKind::MemoryRead:
         // TODO: refactor to functions that both handle generic read/write
         // and sets data accesses outside of cycle/on narrow
-        handleRemillRead(retId, addrId, size);
+        handleRemillRead(call.res, call.args[0].id, call.size);
 
-        if (!this->isInCycle || this->narrowing) {
-            this->dataAccesses[callNode->getId()] = {
-                this->getSVFVarSet(addrId, this->blockState), size};
-        }
-    } else if (fun_name.rfind("__remill_write_memory", 0) == 0) {
-        SVF::NodeID addrId = callNode->getArgument(1)->getId();
-        SVF::NodeID valueId = callNode->getArgument(2)->getId();
-        size_t size = WRITE_FNS_TO_SIZES.at(fun_name);
-
-        handleRemillWrite(addrId, valueId, size);
+        this->recordAccess(
+            callNode, this->getSVFVarSet(call.args[0].id, this->blockState),
+            call.size);
+        break;
+    case CallKind::MemoryWrite:
+        handleRemillWrite(call.args[0].id, call.args[1].id, call.size);
 
-        if (!this->isInCycle || this->narrowing) {
-            this->dataAccesses[callNode->getId()] = {
-                this->getSVFVarSet(addrId, this->blockState), size};
-        }
-    } else if (fun_name == "EXTERNAL.__isoc99_scanf") {
-        SVF::NodeID retId = callNode->getRetICFGNode()->getActualRet()->getId();
-        handleScanf(retId);
+        this->recordAccess(
+            callNode, this->getSVFVarSet(call.args[0].id, this->blockState),
+            call.size);
+        break;
+    case CallKind::Scanf:
+        handleScanf(call.res);
 
-        if (!this->isInCycle || this->narrowing) {
-            this->dataAccesses[callNode->getId()] = {
-                this->blockState.getRegisterSet("RSI"), 8};
-        }
-    } else if (SVF::SVFUtil::isExtCall(callee)) {
+        this->recordAccess(callNode,
+                           this->blockState.getRegisterSet(Register::RSI),
+                           call.size);
+        break;
+    case CallKind::External:
         // `@EXTERNAL.` calls
         updateStateOnExtCall(callNode);
-    } else if (recursiveFuns.find(callee) != recursiveFuns.end()) {
-        // skip recursive functions
-        return;
-    } else {
+        break;
+    case CallKind::Function:
         // Handle the callee function
-        handleFunction(svfir->getICFG()->getFunEntryICFGNode(callee));
+        handleFunction(svfir->getICFG()->getFunEntryICFGNode(
+            callNode->getCalledFunction()));
+        break;
+    // skip recursive functions, and intrinsics that change nothing
+    case CallKind::Recursive:
+    case CallKind::Ignored:
+        break;
+    }
+}
+
+/// @brief Decode a call into a `CallSite` instruction, resolving how its
+/// callee is handled (see `IntrinsicTable`) and the arguments and return
+/// value that the handler needs.
+Instruction VSA::lowerCall(const SVF::CallICFGNode *callNode) {
+    Instruction inst{Opcode::CallSite};
+    inst.call = callNode;
+
+    const SVF::FunObjVar *callee = callNode->getCalledFunction();
+
+    if (const Intrinsic *intrinsic =
+            IntrinsicTable::getTable().lookup(callee->getName())) {
+        inst.callee = intrinsic->kind;
+        inst.size = intrinsic->size;
+    } else if (SVF::SVFUtil::isExtCall(callee)) {
+        inst.callee = CallKind::External;
+    } else if (recursiveFuns.find(callee) != recursiveFuns.end()) {
+        inst.callee = CallKind::Recursive;
+    }
+
+    switch (inst.callee) {
+    case CallKind::MemoryRead:
+        inst.res = callNode->getRetICFGNode()->getActualRet()->getId();
+        inst.args[0].id = callNode->getArgument(1)->getId();
+        break;
+    case CallKind::MemoryWrite:
+        inst.args[0].id = callNode->getArgument(1)->getId();
+        inst.args[1].id = callNode->getArgument(2)->getId();
+        break;
+    case CallKind::Scanf:
+        inst.res = callNode->getRetICFGNode()->getActualRet()->getId();
+        break;
+    default:
+        break;
+    }
+
+    return inst;
+}
+
+/// @brief Decode the statements of a node into instructions, and append
+/// them to `this->instructions`. A call node also gets a `CallSite`
+/// instruction after its statements.
+void VSA::lowerNode(const SVF::ICFGNode *node) {
+    SVF::NodeID id = node->getId();
+    if (id >= this->nodeInstructions.size()) {
+        this->nodeInstructions.resize(id + 1, {NOT_LOWERED, NOT_LOWERED});
+    }
+
+    uint32_t begin = this->instructions.size();
+
+    for (const SVF::SVFStmt *stmt : node->getSVFStmts()) {
+        this->lowerStmt(stmt);
+    }
+
+    if (const SVF::CallICFGNode *callNode =
+            SVF::SVFUtil::dyn_cast<SVF::CallICFGNode>(node)) {
+        this->instructions.push_back(this->lowerCall(callNode));
     }
+
+    this->nodeInstructions[id] = {begin, (uint32_t)this->instructions.size()};
 }
 
 /**
- * @brief Handle state updates for each type of SVF statement
+ * @brief Decode one SVF statement into (at most) one instruction
  *
- * This function updates the abstract state based on the type of SVF statement
- * provided. It dispatches the handling of each specific statement type to the
- * corresponding update function.
+ * This function dispatches on the type of SVF statement provided, and
+ * resolves everything about it that doesn't depend on the abstract state:
+ * its operands, its operator, and what its pointer refers to. Statements
+ * that never change the abstract state don't produce an instruction.
  *
- * @param stmt The SVF statement for which the state needs to be updated
+ * @param stmt The SVF statement to decode
  */
-void VSA::updateAbsState(const SVF::SVFStmt *stmt) {
-    // Handle address statements
+void VSA::lowerStmt(const SVF::SVFStmt *stmt) {
+    Instruction inst{Opcode::Copy};
+
+    // Handle address statements - only the ones that initialise constants
+    // do anything, so they become copies of the constant
     if (const SVF::AddrStmt *addr =
             SVF::SVFUtil::dyn_cast<SVF::AddrStmt>(stmt)) {
-        updateStateOnAddr(addr);
+        if (addr->getRHSVarID() != 3) {
+            return;
+        }
+
+        SVF::ValVar *valVar =
+            SVF::SVFUtil::cast<SVF::ValVar>(addr->getLHSVar());
+        inst.res = valVar->getId();
+        inst.args[0].isGlobal = true;
+
+        // Currently only handles ConstIntValVar and ConstNullPtrValVar
+        if (const SVF::ConstIntValVar *consInt =
+                SVF::SVFUtil::dyn_cast<SVF::ConstIntValVar>(valVar)) {
+            inst.args[0].global = ValueSet(consInt->getSExtValue());
+        } else if (SVF::SVFUtil::isa<SVF::ConstNullPtrValVar>(valVar)) {
+            inst.args[0].global = ValueSet(0);
+        } else {
+            return;
+        }
     }
     // Handle binary operation statements
     else if (const SVF::BinaryOPStmt *binary =
                  SVF::SVFUtil::dyn_cast<SVF::BinaryOPStmt>(stmt)) {
-        updateStateOnBinary(binary);
+        inst.opcode = Opcode::Binary;
+        inst.code = binary->getOpcode();
+        inst.res = binary->getResID();
+        inst.args[0] = this->lowerOperand(binary->getOpVarID(0));
+        inst.args[1] = this->lowerOperand(binary->getOpVarID(1));
     }
     // Handle comparison statements
     else if (const SVF::CmpStmt *cmp =
                  SVF::SVFUtil::dyn_cast<SVF::CmpStmt>(stmt)) {
-        updateStateOnCmp(cmp);
+        inst.opcode = Opcode::Cmp;
+        inst.code = cmp->getPredicate();
+        inst.res = cmp->getResID();
+        inst.args[0] = this->lowerOperand(cmp->getOpVarID(0));
+        inst.args[1] = this->lowerOperand(cmp->getOpVarID(1));
     }
     // Handle load statements
     else if (const SVF::LoadStmt *load =
                  SVF::SVFUtil::dyn_cast<SVF::LoadStmt>(stmt)) {
-        updateStateOnLoad(load);
+        inst.opcode = Opcode::Load;
+        inst.location = this->lowerLocation(load->getRHSVar(),
+                                            load->getLHSVar(), inst.alias);
+        inst.res = load->getLHSVarID();
+
+        if (inst.location == Location::Other) {
+            return;
+        }
     }
     // Handle store statements
     else if (const SVF::StoreStmt *store =
                  SVF::SVFUtil::dyn_cast<SVF::StoreStmt>(stmt)) {
-        updateStateOnStore(store);
+        inst.opcode = Opcode::Store;
+        inst.location = this->lowerLocation(store->getLHSVar(),
+                                            store->getRHSVar(), inst.alias);
+        inst.args[0] = this->lowerOperand(store->getRHSVarID());
+
+        // Only registers and the PCs can be stored to - RBP is a register
+        // like any other here
+        if (inst.location == Location::FrameBase) {
+            inst.location = Location::Register;
+        }
+
+        if (inst.location == Location::Other) {
+            return;
+        }
     }
     // Handle copy statements
     else if (const SVF::CopyStmt *copy =
                  SVF::SVFUtil::dyn_cast<SVF::CopyStmt>(stmt)) {
-        updateStateOnCopy(copy);
-    }
-    // Handle GEP (GetElementPtr) statements
-    else if (const SVF::GepStmt *gep =
-                 SVF::SVFUtil::dyn_cast<SVF::GepStmt>(stmt)) {
-        // The only useful thing that GEP statements are used for is to extract
-        // register values. However, the rgisters are already named for us, so
-        // we don't actually need to handle them
-    }
-    // Handle phi statements
-    else if (const SVF::PhiStmt *phi =
-                 SVF::SVFUtil::dyn_cast<SVF::PhiStmt>(stmt)) {
-        // We will not run into phi statements in lifted binaries
-    }
-    // Handle call procedure entries
-    else if (const SVF::CallPE *callPE =
-                 SVF::SVFUtil::dyn_cast<SVF::CallPE>(stmt)) {
-        updateStateOnCall(callPE);
-    }
-    // Handle return procedure entries
-    else if (const SVF::RetPE *retPE =
-                 SVF::SVFUtil::dyn_cast<SVF::RetPE>(stmt)) {
-        updateStateOnRet(retPE);
+        inst.res = copy->getLHSVarID();
+        inst.args[0] = this->lowerOperand(copy->getRHSVarID());
     }
     // Handle select statements
     else if (const SVF::SelectStmt *select =
                  SVF::SVFUtil::dyn_cast<SVF::SelectStmt>(stmt)) {
-        updateStateOnSelect(select);
+        inst.opcode = Opcode::Select;
+        inst.res = select->getResID();
+        inst.args[0] = this->lowerOperand(select->getCondition()->getId());
+        inst.args[1] = this->lowerOperand(select->getTrueValue()->getId());
+        inst.args[2] = this->lowerOperand(select->getFalseValue()->getId());
     }
     // Handle branch statements
     else if (const SVF::BranchStmt *branch =
                  SVF::SVFUtil::dyn_cast<SVF::BranchStmt>(stmt)) {
-        updateStateOnBranch(branch);
-    }
-    // Handle unary operations and branch statements (no action needed)
-    else if (SVF::SVFUtil::isa<SVF::UnaryOPStmt>(stmt)) {
-        // Nothing needs to be done for branch statements specifically
+        inst.opcode = Opcode::Branch;
+        inst.block = this->getBlockId(branch->getICFGNode());
+    }
+    // The only useful thing that GEP statements are used for is to extract
+    // register values. However, the registers are already named for us, so
+    // we don't actually need to handle them. We will also not run into phi
+    // statements in lifted binaries, and calls are handled by `CallSite`
+    // instructions rather than their parameter edges.
+    else if (SVF::SVFUtil::isa<SVF::GepStmt>(stmt) ||
+             SVF::SVFUtil::isa<SVF::PhiStmt>(stmt) ||
+             SVF::SVFUtil::isa<SVF::CallPE>(stmt) ||
+             SVF::SVFUtil::isa<SVF::RetPE>(stmt) ||
+             SVF::SVFUtil::isa<SVF::UnaryOPStmt>(stmt)) {
+        return;
     }
     // Assert false for unsupported statement types
     else {
         assert(false && "implement this part");
+        return;
     }
+
+    this->instructions.push_back(inst);
 }
 
-/// Abstract state updates on an AddrStmt
-void VSA::updateStateOnAddr(const SVF::AddrStmt *addr) {
-    if (addr->getRHSVarID() == 3) {
-        SVF::ValVar *valVar =
-            SVF::SVFUtil::cast<SVF::ValVar>(addr->getLHSVar());
-        this->blockState.initSVFVar(valVar);
+/// @brief Decode a read of an SVF variable. Global variables never change
+/// after the global node is run, so their values are folded in.
+Operand VSA::lowerOperand(SVF::NodeID id) {
+    Operand operand;
+    operand.id = id;
+
+    auto globalsFind = this->globalState.find(id);
+    if (globalsFind != this->globalState.end()) {
+        operand.isGlobal = true;
+        operand.global = (*globalsFind).second;
     }
+
+    return operand;
 }
 
-/// Abstract state updates on an CallPE
-void VSA::updateStateOnCall(const SVF::CallPE *call) {
-    /*
-    const SVF::ICFGNode *node = call->getICFGNode();
-    AbstractState &as = getAbsStateFromTrace(node);
-    SVF::NodeID lhs = call->getLHSVarID();
-    SVF::NodeID rhs = call->getRHSVarID();
-    as[lhs] = as[rhs];
-    */
+/// @brief Resolve what the pointer of a load or store refers to, from the
+/// role of the variable (see `initVarRoles`). Pointers into a register's
+/// slot take their width from the value loaded or stored.
+/// @param var the pointer
+/// @param value the value loaded or stored
+/// @param alias set to the register that the pointer refers to, if any
+Location VSA::lowerLocation(const SVF::SVFVar *var, const SVF::SVFVar *value,
+                            RegisterAlias &alias) {
+    VarRole role = this->getVarRole(var->getId())
+                       .resolve(value->getType()->getByteSize());
+    alias = role.alias;
+
+    return role.location;
 }
 
-/// Abstract state updates on an RetPE
-void VSA::updateStateOnRet(const SVF::RetPE *retPE) {
-    /*
-    const SVF::ICFGNode *node = retPE->getICFGNode();
-    AbstractState &as = getAbsStateFromTrace(node);
-    SVF::NodeID lhs = retPE->getLHSVarID();
-    SVF::NodeID rhs = retPE->getRHSVarID();
-    as[lhs] = as[rhs];
-    */
+/// @brief Run the instructions of a node, decoding its statements first if
+/// this is the first time the node is run.
+void VSA::runNode(const SVF::ICFGNode *node) {
+    SVF::NodeID id = node->getId();
+    if (id >= this->nodeInstructions.size() ||
+        this->nodeInstructions[id].first == NOT_LOWERED) {
+        this->lowerNode(node);
+    }
+
+    // Calls may decode more nodes (and so move `this->instructions`), so
+    // the range is walked by index
+    auto range = this->nodeInstructions[id];
+    for (uint32_t i = range.first; i < range.second; i++) {
+        Instruction inst = this->instructions[i];
+        this->updateAbsState(inst);
+    }
 }
 
-void VSA::updateStateOnCopy(const SVF::CopyStmt *copy) {
-    this->blockState.varState[copy->getLHSVarID()] =
-        this->getSVFVarSet(copy->getRHSVarID(), this->blockState);
+/// @brief Update the abstract state by running one decoded instruction
+void VSA::updateAbsState(const Instruction &inst) {
+    switch (inst.opcode) {
+    case Opcode::Copy:
+        updateStateOnCopy(inst);
+        break;
+    case Opcode::Binary:
+        updateStateOnBinary(inst);
+        break;
+    case Opcode::Cmp:
+        updateStateOnCmp(inst);
+        break;
+    case Opcode::Select:
+        updateStateOnSelect(inst);
+        break;
+    case Opcode::Load:
+        updateStateOnLoad(inst);
+        break;
+    case Opcode::Store:
+        updateStateOnStore(inst);
+        break;
+    case Opcode::Branch:
+        updateStateOnBranch(inst);
+        break;
+    case Opcode::CallSite:
+        handleCallSite(inst);
+        break;
+    }
+}
+
+/// @brief Find the value set of an operand - its folded value if it is a
+/// global variable, and its value in the current block otherwise.
+ValueSet VSA::getOperandSet(const Operand &operand) {
+    if (operand.isGlobal) {
+        return operand.global;
+    }
+
+    return this->getLocalSVFVarSet(operand.id, this->blockState);
+}
+
+void VSA::updateStateOnCopy(const Instruction &copy) {
+    this->setSVFVarSet(copy.res, this->getOperandSet(copy.args[0]));
+}
+
+/// @brief Apply a RIC kernel from `RICKernels.hpp`, and the matching
+/// known-bits kernel from `KnownBits.hpp`, to two value sets. Arithmetic
+/// on pointers is not meaningful other than for alignment, so only values
+/// in the global region (i.e. plain numbers) are combined directly.
+static ValueSet applyKernel(ValueSet &lhs, ValueSet &rhs,
+                            RIC (*kernel)(RIC, RIC, int),
+                            KnownBits (*bitsKernel)(KnownBits, KnownBits)) {
+    ValueSet result;
+
+    if (lhs.isTop() || rhs.isTop()) {
+        result.top = true;
+        return result;
+    }
+
+    if (lhs.isBottom() || rhs.isBottom()) {
+        return result;
+    }
+
+    auto rhsGlobal = rhs.values.find(0);
+    if (rhs.values.size() != 1 || rhsGlobal == rhs.values.end()) {
+        result.top = true;
+        return result;
+    }
+
+    // Masking a pointer with a constant (e.g. `and rsp, -16`) keeps it in
+    // the same region, so apply the kernel to the offsets in every region
+    bool alignsPointer = kernel == RICKernels::bitAnd &&
+                         RICKernels::isConstant(rhsGlobal->second);
+    auto lhsGlobal = lhs.values.find(0);
+
+    if (!alignsPointer &&
+        (lhs.values.size() != 1 || lhsGlobal == lhs.values.end())) {
+        result.top = true;
+        return result;
+    }
+
+    KnownBits rhsBits =
+        KnownBitsKernels::effective(rhsGlobal->second, rhsGlobal->bits);
+
+    for (auto entry : lhs.values) {
+        RIC ric =
+            kernel(entry.second, rhsGlobal->second, RICKernels::WORD_WIDTH);
+
+        KnownBits bits;
+        if (KNOWN_BITS_ENABLED) {
+            bits = bitsKernel(
+                KnownBitsKernels::effective(entry.second, entry.bits),
+                rhsBits);
+            reduce(ric, bits);
+        }
+
+        if (!ric.isBottom()) {
+            result.values.pushBack({entry.first, ric, bits});
+        }
+    }
+
+    return result;
+}
+
+/// @brief A constant mask as a value set. Masks such as 0xFFFFFFFF don't fit
+/// in a RIC, in which case only the known bits describe the mask.
+static ValueSet maskSet(int64_t mask) {
+    ValueSet result;
+    result.values.pushBack(
+        {0, RICKernels::constant(mask), KnownBits::constant(mask)});
+
+    return result;
 }
 
 /// Find the comparison predicates in "class SVF::BinaryOPStmt:OpCode" under
@@ -1369,7 +2227,7 @@ void VSA::updateStateOnCopy(const SVF::CopyStmt *copy) {
 /// (The program is assumed to have signed ints and also
 /// interger-overflow-free), including Add, FAdd, Sub, FSub, Mul, FMul, SDiv,
 /// FDiv, UDiv, SRem, FRem, URem, Xor, And, Or, AShr, Shl, LShr
-void VSA::updateStateOnBinary(const SVF::BinaryOPStmt *binary) {
+void VSA::updateStateOnBinary(const Instruction &binary) {
     /*
     const SVF::ICFGNode *node = binary->getICFGNode();
     AbstractState &as = getAbsStateFromTrace(node);
@@ -1416,57 +2274,94 @@ void VSA::updateStateOnBinary(const SVF::BinaryOPStmt *binary) {
         break;
     }
     */
-    auto resID = binary->getResID();
-    auto left = binary->getOpVarID(0);
-    auto right = binary->getOpVarID(1);
+    SVF::NodeID resID = binary.res;
 
-    switch (binary->getOpcode()) {
+    ValueSet lhs = this->getOperandSet(binary.args[0]);
+    ValueSet rhs = this->getOperandSet(binary.args[1]);
+
+    switch (binary.code) {
     case SVF::BinaryOPStmt::Add:
     case SVF::BinaryOPStmt::FAdd: {
         // Adding is always only done on variables
-        this->blockState.varState[resID] =
-            this->getSVFVarSet(left, this->blockState) +
-            this->getSVFVarSet(right, this->blockState);
+        this->setSVFVarSet(resID, lhs + rhs);
         break;
     }
     case SVF::BinaryOPStmt::Sub:
     case SVF::BinaryOPStmt::FSub: {
-        // Assumes RHS is always a constant
-        ValueSet vs = this->getSVFVarSet(left, this->blockState);
-        int rhsConst =
-            this->getSVFVarSet(right, this->blockState).getConstant();
-        vs.adjust(-rhsConst);
-
-        this->blockState.varState[resID] = vs;
+        // Subtracting a constant also works on pointers, e.g. `rsp - 8`
+        if (rhs.getGlobal().isConstant()) {
+            lhs.adjust(-rhs.getConstant());
+            this->setSVFVarSet(resID, lhs);
+        } else {
+            this->setSVFVarSet(resID, applyKernel(lhs, rhs, RICKernels::sub,
+                                                  KnownBitsKernels::sub));
+        }
         break;
     }
+    case SVF::BinaryOPStmt::Mul:
+        this->setSVFVarSet(resID, applyKernel(lhs, rhs, RICKernels::mul,
+                                              KnownBitsKernels::mul));
+        break;
+    case SVF::BinaryOPStmt::SDiv:
+        this->setSVFVarSet(resID, applyKernel(lhs, rhs, RICKernels::div,
+                                              KnownBitsKernels::div));
+        break;
+    case SVF::BinaryOPStmt::UDiv:
+        this->setSVFVarSet(resID, applyKernel(lhs, rhs, RICKernels::udiv,
+                                              KnownBitsKernels::udiv));
+        break;
+    case SVF::BinaryOPStmt::SRem:
+        this->setSVFVarSet(resID, applyKernel(lhs, rhs, RICKernels::rem,
+                                              KnownBitsKernels::rem));
+        break;
+    case SVF::BinaryOPStmt::URem:
+        this->setSVFVarSet(resID, applyKernel(lhs, rhs, RICKernels::urem,
+                                              KnownBitsKernels::urem));
+        break;
+    case SVF::BinaryOPStmt::And:
+        this->setSVFVarSet(resID, applyKernel(lhs, rhs, RICKernels::bitAnd,
+                                              KnownBitsKernels::bitAnd));
+        break;
+    case SVF::BinaryOPStmt::Or:
+        this->setSVFVarSet(resID, applyKernel(lhs, rhs, RICKernels::bitOr,
+                                              KnownBitsKernels::bitOr));
+        break;
     case SVF::BinaryOPStmt::Xor:
-        // The only XORs we care about are ones that set a variable to 0
-        // TODO: patch once we actually implement xor
-        this->blockState.varState[resID] = 0;
+        // `xor reg, reg` is the usual way of setting a register to 0
+        if (binary.args[0].id == binary.args[1].id) {
+            this->setSVFVarSet(resID, ValueSet(0));
+        } else {
+            this->setSVFVarSet(resID, applyKernel(lhs, rhs, RICKernels::bitXor,
+                                                  KnownBitsKernels::bitXor));
+        }
         break;
     case SVF::BinaryOPStmt::Shl:
-        this->blockState.varState[resID] =
-            this->getSVFVarSet(left, this->blockState)
-            << this->getSVFVarSet(right, this->blockState).getConstant();
+        this->setSVFVarSet(resID, applyKernel(lhs, rhs, RICKernels::shl,
+                                              KnownBitsKernels::shl));
+        break;
+    case SVF::BinaryOPStmt::LShr:
+        this->setSVFVarSet(resID, applyKernel(lhs, rhs, RICKernels::lshr,
+                                              KnownBitsKernels::lshr));
+        break;
+    case SVF::BinaryOPStmt::AShr:
+        this->setSVFVarSet(resID, applyKernel(lhs, rhs, RICKernels::ashr,
+                                              KnownBitsKernels::ashr));
+        break;
+    default:
         break;
     }
 }
 
 /// Abstract state updates on an SVF::CmpStmt
-void VSA::updateStateOnCmp(const SVF::CmpStmt *cmp) {
-    const SVF::ICFGNode *node = cmp->getICFGNode();
-
-    u32_t op0 = cmp->getOpVarID(0);
-    u32_t op1 = cmp->getOpVarID(1);
-    u32_t res = cmp->getResID();
+void VSA::updateStateOnCmp(const Instruction &cmp) {
+    u32_t res = cmp.res;
 
     RIC resVal;
-    RIC lhs = this->getSVFVarSet(op0, this->blockState).getGlobal(),
-        rhs = this->getSVFVarSet(op1, this->blockState).getGlobal();
+    RIC lhs = this->getOperandSet(cmp.args[0]).getGlobal(),
+        rhs = this->getOperandSet(cmp.args[1]).getGlobal();
 
     // AbstractValue
-    auto predicate = cmp->getPredicate();
+    auto predicate = cmp.code;
 
     switch (predicate) {
     case SVF::CmpStmt::ICMP_EQ:
@@ -1518,7 +2413,9 @@ void VSA::updateStateOnCmp(const SVF::CmpStmt *cmp) {
         */
     }
 
-    this->blockState.varState[res].values[0] = resVal;
+    ValueSet resSet = this->getLocalSVFVarSet(res, this->blockState);
+    resSet.values[0] = resVal;
+    this->setSVFVarSet(res, resSet);
 
     /*
     if (as.inVarToValTable(op0) && as.inVarToValTable(op1)) {
@@ -1627,25 +2524,30 @@ void VSA::updateStateOnCmp(const SVF::CmpStmt *cmp) {
 /// manipulation of abstract stores is the intrinsic function(s)
 /// `@__remill_write`.
 /// @param load
-void VSA::updateStateOnStore(const SVF::StoreStmt *store) {
-    auto lhs = store->getLHSVar();
-    auto rhs = store->getRHSVar();
-
+void VSA::updateStateOnStore(const Instruction &store) {
+    switch (store.location) {
     // PC and NEXT_PC treated as constants
-    if (lhs->getName() == "PC") {
-        ValueSet rhsSet = this->blockState.getSVFVarSet(rhs->getId());
-        this->pc = rhsSet.getConstant();
-    } else if (lhs->getName() == "NEXT_PC") {
-        ValueSet rhsSet = this->blockState.getSVFVarSet(rhs->getId());
-        this->nextPc = rhsSet.getConstant();
-    } else if (lhs->getName() == "RETURN_PC") {
-        ValueSet rhsSet = this->blockState.getSVFVarSet(rhs->getId());
-        this->returnPc = rhsSet.getConstant();
-    }
+    case Location::PC:
+        this->pc =
+            this->getLocalSVFVarSet(store.args[0].id, this->blockState)
+                .getConstant();
+        break;
+    case Location::NextPC:
+        this->nextPc =
+            this->getLocalSVFVarSet(store.args[0].id, this->blockState)
+                .getConstant();
+        break;
+    case Location::ReturnPC:
+        this->returnPc =
+            this->getLocalSVFVarSet(store.args[0].id, this->blockState)
+                .getConstant();
+        break;
     // Store value to register
-    else if (this->blockState.isRegister(lhs->getName())) {
-        ValueSet rhsSet = this->getSVFVarSet(rhs->getId(), this->blockState);
-        this->blockState.abstractStore.registers[lhs->getName()] = rhsSet;
+    case Location::Register:
+        this->writeRegister(store.alias, this->getOperandSet(store.args[0]));
+        break;
+    default:
+        break;
     }
 }
 
@@ -1654,63 +2556,113 @@ void VSA::updateStateOnStore(const SVF::StoreStmt *store) {
 /// manipulation of abstract stores is the intrinsic function(s)
 /// `@__remill_read`.
 /// @param load
-void VSA::updateStateOnLoad(const SVF::LoadStmt *load) {
-    auto lhs = load->getLHSVar();
-    auto rhs = load->getRHSVar();
-
+void VSA::updateStateOnLoad(const Instruction &load) {
+    switch (load.location) {
     // PC and NEXT_PC treated as constants
-    if (rhs->getName() == "PC") {
-        this->blockState.varState.insert({lhs->getId(), ValueSet(this->pc)});
-    } else if (rhs->getName() == "NEXT_PC") {
-        this->blockState.varState.insert(
-            {lhs->getId(), ValueSet(this->nextPc)});
-    } else if (rhs->getName() == "RETURN_PC") {
-        this->blockState.varState.insert(
-            {lhs->getId(), ValueSet(this->returnPc)});
-    }
+    case Location::PC:
+        this->setSVFVarSet(load.res, ValueSet(this->pc));
+        break;
+    case Location::NextPC:
+        this->setSVFVarSet(load.res, ValueSet(this->nextPc));
+        break;
+    case Location::ReturnPC:
+        this->setSVFVarSet(load.res, ValueSet(this->returnPc));
+        break;
     // RBP treated as offset of memory region corresponding to procedure
-    else if (rhs->getName() == "RBP") {
+    case Location::FrameBase: {
         ValueSet vs;
         vs.values[1] = RIC(this->blockState.stackSize);
-        this->blockState.varState.insert({lhs->getId(), vs});
+        this->setSVFVarSet(load.res, vs);
+        break;
     }
     // Load value from register
-    else if (this->blockState.isRegister(rhs->getName())) {
-        this->blockState.varState.insert(
-            {lhs->getId(), this->blockState.getRegisterSet(rhs->getName())});
+    case Location::Register:
+        this->setSVFVarSet(load.res, this->readRegister(load.alias));
+        break;
+    default:
+        break;
     }
 }
 
-void VSA::updateStateOnExtCall(const SVF::CallICFGNode *extCallNode) {}
+/// @brief Read a register, masking out the bytes of its slot that a
+/// sub-register (e.g. EAX or AH) doesn't cover.
+ValueSet VSA::readRegister(RegisterAlias alias) {
+    ValueSet full = this->blockState.getRegisterSet(alias.reg);
+    if (alias.isFullWidth()) {
+        return full;
+    }
 
-void VSA::updateStateOnSelect(const SVF::SelectStmt *select) {
-    const SVF::ICFGNode *node = select->getICFGNode();
+    ValueSet shift(8 * alias.shift);
+    ValueSet shifted = applyKernel(full, shift, RICKernels::lshr,
+                                   KnownBitsKernels::lshr);
+
+    ValueSet mask = maskSet(alias.mask());
+    return applyKernel(shifted, mask, RICKernels::bitAnd,
+                       KnownBitsKernels::bitAnd);
+}
+
+/// @brief Write a register. Writing a sub-register (e.g. a `store i32`
+/// through Remill's `EAX`) only writes its own bytes and keeps the other
+/// bytes of the slot - x86-64's zero-extension of 32-bit writes is lifted
+/// as an explicit 64-bit store to the full register.
+void VSA::writeRegister(RegisterAlias alias, ValueSet value) {
+    ValueSetRef &slot = this->blockState.abstractStore.registers[alias.reg];
+
+    if (alias.isFullWidth()) {
+        slot = value;
+        return;
+    }
+
+    ValueSet mask = maskSet(alias.mask());
+    ValueSet written = applyKernel(value, mask, RICKernels::bitAnd,
+                                   KnownBitsKernels::bitAnd);
+
+    ValueSet shift(8 * alias.shift);
+    written =
+        applyKernel(written, shift, RICKernels::shl, KnownBitsKernels::shl);
+
+    // The other bytes of a register that was never written are unknown
+    ValueSet kept = slot;
+    if (kept.isBottom()) {
+        kept.top = true;
+    }
+
+    ValueSet keptMask = maskSet(~(alias.mask() << (8 * alias.shift)));
+    kept = applyKernel(kept, keptMask, RICKernels::bitAnd,
+                       KnownBitsKernels::bitAnd);
+
+    slot = applyKernel(kept, written, RICKernels::bitOr,
+                       KnownBitsKernels::bitOr);
+}
+
+void VSA::updateStateOnExtCall(const SVF::CallICFGNode *extCallNode) {}
 
-    u32_t res = select->getResID();
-    u32_t tval = select->getTrueValue()->getId();
-    u32_t fval = select->getFalseValue()->getId();
-    u32_t cond = select->getCondition()->getId();
+void VSA::updateStateOnSelect(const Instruction &select) {
+    const Operand &cond = select.args[0];
+    const Operand &tval = select.args[1];
+    const Operand &fval = select.args[2];
 
-    ValueSet condVs = this->getSVFVarSet(cond, this->blockState);
+    ValueSet condVs = this->getOperandSet(cond);
 
     if (condVs.getGlobal().isConstant()) {
         int condConst = condVs.getConstant();
-        this->blockState.varState[res] =
-            (condConst == 0) ? this->getSVFVarSet(fval, this->blockState)
-                             : this->getSVFVarSet(tval, this->blockState);
+        this->setSVFVarSet(select.res, (condConst == 0)
+                                            ? this->getOperandSet(fval)
+                                            : this->getOperandSet(tval));
     } else {
         ValueSet vs;
-        vs.joinWith(this->getSVFVarSet(fval, this->blockState));
-        vs.joinWith(this->getSVFVarSet(tval, this->blockState));
-        this->blockState.varState[res] = vs;
+        vs.joinWith(this->getOperandSet(fval));
+        vs.joinWith(this->getOperandSet(tval));
+        this->setSVFVarSet(select.res, vs);
     }
 }
 
-void VSA::updateStateOnBranch(const SVF::BranchStmt *branch) {
+void VSA::updateStateOnBranch(const Instruction &branch) {
     // Branch is the end of a basic block, so we store our accumulated info
     // into `postBasicBlock`
-    this->postBasicBlock[branch->getICFGNode()] = this->blockState;
-    this->postBasicBlock[branch->getICFGNode()].nextPc = this->nextPc;
+    Snapshot &post = this->postBasicBlock[branch.block];
+    post = this->blockState;
+    post.nextPc = this->nextPc;
 
     // Clear all local variables
     this->blockState.varState.clear();
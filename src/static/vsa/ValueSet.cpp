@@ -1,15 +1,38 @@
 #include <limits>
 #include <static/vsa/ValueSet.hpp>
 
+uint32_t ValueSet::regionLimit = 0;
+size_t ValueSet::regionLimitHits = 0;
+
+/// Every bit known about the offsets in a region
+static KnownBits effectiveBits(const RegionEntry &entry) {
+    return KnownBitsKernels::effective(entry.second, entry.bits);
+}
+
+/// Known bits of the join of two regions, which are only worked out if
+/// either side knows more than its RIC does
+static KnownBits joinBits(const RegionEntry &lhs, const RegionEntry &rhs) {
+    if (lhs.bits.isUnknown() && rhs.bits.isUnknown()) {
+        return KnownBits();
+    }
+
+    return effectiveBits(lhs).join(effectiveBits(rhs));
+}
+
 bool ValueSet::operator==(ValueSet &rhs) {
+    // Both region maps are sorted, so walk through them together
+    auto rhsIt = rhs.values.begin();
+
     for (auto kv : this->values) {
-        auto rhsKv = rhs.values.find(kv.first);
+        while (rhsIt != rhs.values.end() && rhsIt->first < kv.first) {
+            rhsIt++;
+        }
 
-        if (rhsKv == rhs.values.end()) {
+        if (rhsIt == rhs.values.end() || rhsIt->first != kv.first) {
             return false;
         }
 
-        if (kv.second != (*rhsKv).second) {
+        if (kv.second != rhsIt->second || kv.bits != rhsIt->bits) {
             return false;
         }
     }
@@ -22,7 +45,8 @@ bool ValueSet::operator!=(ValueSet &rhs) {
 }
 
 ValueSet ValueSet::operator+(ValueSet rhs) {
-    if (this->values.find(0) != this->values.end() && this->getGlobal().isConstant()) {
+    if (this->values.find(0) != this->values.end() &&
+        this->getGlobal().isConstant()) {
         // Value at memory region 0 is constant
         ValueSet vs = rhs;
         vs.adjust(this->getConstant());
@@ -39,6 +63,8 @@ ValueSet ValueSet::operator+(ValueSet rhs) {
             } else {
                 kv->second = TOP;
             }
+
+            kv->bits = KnownBits();
         }
 
         return vs;
@@ -53,12 +79,14 @@ ValueSet ValueSet::operator+(ValueSet rhs) {
 
 ValueSet ValueSet::operator<<(int shift) {
     ValueSet vs = (*this);
-    
+
     for (auto it = vs.values.begin(); it != vs.values.end(); it++) {
         RIC ric = it->second;
         ric.stride <<= shift;
         ric.offset <<= shift;
         it->second = ric;
+        it->bits = KnownBitsKernels::extraBits(
+            ric, KnownBitsKernels::shl(it->bits, KnownBits::constant(shift)));
     }
 
     return vs;
@@ -79,96 +107,193 @@ bool ValueSet::isBottom() {
 }
 
 bool ValueSet::isSubset(ValueSet &rhs) {
+    auto rhsIt = rhs.values.begin();
+
     for (auto locMapping : this->values) {
-        uint64_t region = locMapping.first;
-        auto rhsRegion = rhs.values.find(region);
+        RegionID region = locMapping.first;
 
-        if (rhsRegion == rhs.values.end()) {
+        while (rhsIt != rhs.values.end() && rhsIt->first < region) {
+            rhsIt++;
+        }
+
+        if (rhsIt == rhs.values.end() || rhsIt->first != region) {
             return false;
         }
 
-        RIC rhsRic = (*rhsRegion).second;
+        RIC rhsRic = rhsIt->second;
 
         if (!locMapping.second.isSubset(rhsRic)) {
             return false;
         }
+
+        if (!rhsIt->bits.isUnknown() &&
+            !effectiveBits(locMapping).isSubset(rhsIt->bits)) {
+            return false;
+        }
     }
 
     return true;
 }
 
 void ValueSet::meetWith(ValueSet &rhs) {
-    for (auto it = this->values.begin(); it != this->values.end();) {
-        // Find region in other section
-        uint64_t region = (*it).first;
-        auto rhsRegion = rhs.values.find(region);
+    // Compact the regions that are in both value sets to the front
+    auto out = this->values.begin();
+    auto rhsIt = rhs.values.begin();
 
-        if (rhsRegion == rhs.values.end()) {
-            it = this->values.erase(it);
-        } else {
-            (*it).second.meetWith((*rhsRegion).second);
-            it++;
+    for (auto it = this->values.begin(); it != this->values.end(); it++) {
+        while (rhsIt != rhs.values.end() && rhsIt->first < it->first) {
+            rhsIt++;
         }
+
+        if (rhsIt == rhs.values.end() || rhsIt->first != it->first) {
+            continue;
+        }
+
+        RIC ric = it->second;
+        ric.meetWith(rhsIt->second);
+
+        KnownBits bits = it->bits.meet(rhsIt->bits);
+        reduce(ric, bits);
+
+        *out = {it->first, ric, bits};
+        out++;
     }
+
+    this->values.erase(out, this->values.end());
 }
 
-void ValueSet::joinWith(ValueSet rhs) {
-    // Find regions in other section to either add or join to
-    for (auto it = rhs.values.begin(); it != rhs.values.end(); it++) {
-        // Find corresponding regions in this
-        uint64_t region = (*it).first;
-        auto lhsRegion = this->values.find(region);
+bool ValueSet::joinWith(ValueSet rhs) {
+    // Merge the two sorted region maps, joining regions found in both
+    RegionMap joined;
+
+    auto lhsIt = this->values.begin();
+    auto rhsIt = rhs.values.begin();
 
-        if (lhsRegion == this->values.end()) {
-            this->values.insert(std::pair<uint64_t, RIC>(region, (*it).second));
+    while (lhsIt != this->values.end() && rhsIt != rhs.values.end()) {
+        if (lhsIt->first < rhsIt->first) {
+            joined.pushBack(*lhsIt);
+            lhsIt++;
+        } else if (rhsIt->first < lhsIt->first) {
+            joined.pushBack(*rhsIt);
+            rhsIt++;
         } else {
-            (*lhsRegion).second.joinWith((*it).second);
+            RIC ric = lhsIt->second;
+            ric.joinWith(rhsIt->second);
+
+            KnownBits bits = joinBits(*lhsIt, *rhsIt);
+            reduce(ric, bits);
+
+            joined.pushBack({lhsIt->first, ric, bits});
+            lhsIt++;
+            rhsIt++;
         }
     }
+
+    for (; lhsIt != this->values.end(); lhsIt++) {
+        joined.pushBack(*lhsIt);
+    }
+
+    for (; rhsIt != rhs.values.end(); rhsIt++) {
+        joined.pushBack(*rhsIt);
+    }
+
+    if (regionLimit != 0 && joined.size() > regionLimit) {
+        regionLimitHits++;
+        this->top = true;
+        this->values.clear();
+        return true;
+    }
+
+    bool changed = this->values != joined;
+    this->values = std::move(joined);
+
+    return changed;
 }
 
 /// @brief Widens the current value set, according to some other
 /// value set. Currently can only widen in one direction.
-/// @param rhs 
-void ValueSet::widenWith(ValueSet &rhs) {
+/// @param rhs
+/// @return Whether this value set changed
+bool ValueSet::widenWith(ValueSet &rhs) {
+    auto rhsRegion = rhs.values.begin();
+    bool changed = false;
+
     for (auto kv = this->values.begin(); kv != this->values.end(); kv++) {
-        auto rhsRegion = rhs.values.find((*kv).first);
+        while (rhsRegion != rhs.values.end() &&
+               rhsRegion->first < (*kv).first) {
+            rhsRegion++;
+        }
+
         if (rhsRegion == rhs.values.end()) {
-            continue;
+            break;
         }
 
-        (*kv).second.widenWith((*rhsRegion).second);
+        if (rhsRegion->first == (*kv).first) {
+            // Known bits can only be lost finitely often, so joining them is
+            // already a widening. The widened RIC isn't reduced, so that
+            // it can't shrink back down.
+            KnownBits bits = joinBits(*kv, *rhsRegion);
+            KnownBits before = (*kv).bits;
+
+            changed |= (*kv).second.widenWith((*rhsRegion).second);
+            (*kv).bits = KnownBitsKernels::extraBits((*kv).second, bits);
+            changed |= (*kv).bits != before;
+        }
     }
+
+    return changed;
 }
 
-void ValueSet::narrowWith(ValueSet &rhs) {
+bool ValueSet::narrowWith(ValueSet &rhs) {
+    auto rhsRegion = rhs.values.begin();
+    bool changed = false;
+
     for (auto kv = this->values.begin(); kv != this->values.end(); kv++) {
-        auto rhsRegion = rhs.values.find((*kv).first);
+        while (rhsRegion != rhs.values.end() &&
+               rhsRegion->first < (*kv).first) {
+            rhsRegion++;
+        }
+
         if (rhsRegion == rhs.values.end()) {
-            continue;
+            break;
         }
 
-        (*kv).second.narrowWith((*rhsRegion).second);
+        if (rhsRegion->first == (*kv).first) {
+            RIC before = (*kv).second;
+            KnownBits beforeBits = (*kv).bits;
+
+            (*kv).second.narrowWith((*rhsRegion).second);
+            (*kv).bits = (*kv).bits.meet((*rhsRegion).bits);
+            reduce((*kv).second, (*kv).bits);
+
+            changed |= (*kv).second != before || (*kv).bits != beforeBits;
+        }
     }
+
+    return changed;
 }
 
 void ValueSet::adjust(int c) {
     for (auto it = this->values.begin(); it != this->values.end(); it++) {
         // TODO: handle other infinite cases
-        if (!(*it).second.end.is_plus_infinity())
+        if (!(*it).second.end.is_plus_infinity()) {
             (*it).second.offset += c;
+            (*it).bits = KnownBitsKernels::extraBits(
+                (*it).second,
+                KnownBitsKernels::add((*it).bits, KnownBits::constant(c)));
+        }
     }
 }
 
 void ValueSet::removeLowerBounds() {
     for (auto ric : this->values) {
-        ric.second.start = SVF::BoundedInt::minus_infinity();
+        ric.second.start = Bound::minus_infinity();
     }
 }
 
 void ValueSet::removeUpperBounds() {
     for (auto ric : this->values) {
-        ric.second.end = SVF::BoundedInt::plus_infinity();
+        ric.second.end = Bound::plus_infinity();
     }
 }
 
@@ -176,7 +301,14 @@ std::string ValueSet::toString() {
     std::string vsString = "{";
 
     for (auto kv : this->values) {
-        vsString += "region" + std::to_string(kv.first) + ": " + kv.second.toString() + ", ";
+        vsString += "region" + std::to_string(kv.first) + ": " +
+                    kv.second.toString();
+
+        if (!kv.bits.isUnknown()) {
+            vsString += " & " + kv.bits.toString();
+        }
+
+        vsString += ", ";
     }
 
     vsString += "}";
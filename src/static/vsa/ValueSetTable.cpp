@@ -0,0 +1,53 @@
+#include <functional>
+#include <static/vsa/ValueSetTable.hpp>
+
+/// Mixes `value` into the running hash `seed` (as in `boost::hash_combine`)
+static void hashCombine(size_t &seed, uint64_t value) {
+    seed ^= std::hash<uint64_t>()(value) + 0x9e3779b97f4a7c15ULL +
+            (seed << 6) + (seed >> 2);
+}
+
+size_t ValueSetHash::operator()(const ValueSet &vs) const {
+    size_t seed = vs.top;
+
+    for (auto &kv : vs.values) {
+        const RIC &ric = kv.second;
+
+        hashCombine(seed, kv.first);
+        hashCombine(seed, ric.stride);
+        hashCombine(seed, ric.start.getIntNumeral());
+        hashCombine(seed, ric.end.getIntNumeral());
+        hashCombine(seed, ric.offset);
+        hashCombine(seed, kv.bits.zeros);
+        hashCombine(seed, kv.bits.ones);
+    }
+
+    return seed;
+}
+
+bool ValueSetEqual::operator()(const ValueSet &lhs, const ValueSet &rhs) const {
+    return lhs.top == rhs.top && lhs.values == rhs.values;
+}
+
+ValueSetTable &ValueSetTable::getTable() {
+    static ValueSetTable table;
+    return table;
+}
+
+/// @brief Find the canonical ID of a value set, adding it to the table if
+/// it has not been seen before.
+uint32_t ValueSetTable::intern(const ValueSet &vs) {
+    std::vector<uint32_t> &bucket = this->buckets[ValueSetHash()(vs)];
+
+    for (uint32_t id : bucket) {
+        if (ValueSetEqual()(this->values[id], vs)) {
+            return id;
+        }
+    }
+
+    uint32_t id = this->values.size();
+    this->values.push_back(vs);
+    bucket.push_back(id);
+
+    return id;
+}
@@ -0,0 +1,125 @@
+#include <static/vsa/VarRole.hpp>
+
+/// Field of `gpr` in Remill's `%struct.X86State`
+static const int64_t GPR_FIELD = 6;
+
+/// @brief Registers in the order of Remill's `GPR` struct, which puts a
+/// padding field before each one, so register `i` is field `2 * i + 1`.
+/// The last one is RIP, which is the program counter.
+static const Register GPR_FIELDS[] = {
+    Register::RAX, Register::RBX, Register::RCX, Register::RDX,
+    Register::RSI, Register::RDI, Register::RSP, Register::RBP,
+    Register::R8,  Register::R9,  Register::R10, Register::R11,
+    Register::R12, Register::R13, Register::R14, Register::R15,
+    Register::None};
+
+/// @brief Resolve the role of a pointer for one load or store through it,
+/// giving a pointer into a register's slot the width of the access. A
+/// full-width access to RBP is the frame base.
+/// @param width size in bytes of the value loaded or stored
+VarRole VarRole::resolve(uint32_t width) const {
+    VarRole role = *this;
+    if (!this->alias.isRegister() || this->alias.width != 0) {
+        return role;
+    }
+
+    role.alias.width = width == 1 || width == 2 || width == 4 ? width : 8;
+
+    // Only the low byte has a high byte above it
+    if (role.alias.shift != 0 && role.alias.width != 1) {
+        return VarRole();
+    }
+
+    if (role.alias.reg == Register::RBP && role.alias.isFullWidth()) {
+        role.location = Location::FrameBase;
+    }
+
+    return role;
+}
+
+/// @brief Whether the role Remill's name for a variable gives agrees with
+/// this role, found from the structure of the bitcode. A pointer into a
+/// register's slot agrees with any width of that register.
+bool VarRole::agreesWith(const VarRole &named) const {
+    if (this->alias.isRegister() && this->alias.width == 0) {
+        return (named.location == Location::Register ||
+                named.location == Location::FrameBase) &&
+               named.alias.reg == this->alias.reg &&
+               named.alias.shift == this->alias.shift;
+    }
+
+    return *this == named;
+}
+
+/// @brief Classify a variable by the name Remill gives it. `PC` and `RBP`
+/// are GEPs into `%struct.State`, while `NEXT_PC` and `RETURN_PC` are
+/// allocas in every lifted function.
+VarRole VarRole::fromName(const std::string &name) {
+    VarRole role;
+
+    if (name == "PC") {
+        role.location = Location::PC;
+    } else if (name == "NEXT_PC") {
+        role.location = Location::NextPC;
+    } else if (name == "RETURN_PC") {
+        role.location = Location::ReturnPC;
+    } else {
+        role.alias = RegisterAlias::fromName(name);
+
+        if (name == "RBP") {
+            role.location = Location::FrameBase;
+        } else if (role.alias.isRegister()) {
+            role.location = Location::Register;
+        }
+    }
+
+    return role;
+}
+
+/// @brief Classify a GEP into `%struct.State` by its constant indices,
+/// including the leading index of the pointer itself. `%struct.State` only
+/// wraps `%struct.X86State`, so GEPs can index either of them, e.g. both
+/// `0, 0, 6, 1, 0, 0` into `State` and `0, 6, 1` into `X86State` are
+/// `state.gpr.rax`. Every register is a `Reg { union { i64 } }`, so its
+/// sub-registers are the same GEP as the register itself, and their width
+/// is only known from each access. An index past the `i64` picks one of
+/// its bytes, e.g. 1 for AH.
+VarRole VarRole::fromStatePath(const std::vector<int64_t> &path) {
+    VarRole role;
+
+    size_t fieldIndex;
+    if (path.size() >= 4 && path[0] == 0 && path[1] == 0 &&
+        path[2] == GPR_FIELD) {
+        fieldIndex = 3;
+    } else if (path.size() >= 3 && path[0] == 0 && path[1] == GPR_FIELD) {
+        fieldIndex = 2;
+    } else {
+        return role;
+    }
+
+    int64_t field = path[fieldIndex];
+    size_t fieldCount = sizeof(GPR_FIELDS) / sizeof(GPR_FIELDS[0]);
+    if (field < 0 || field % 2 == 0 || (size_t)(field / 2) >= fieldCount) {
+        return role;
+    }
+
+    // `Reg`, then its union, then the byte of the union's `i64`
+    int64_t shift = 0;
+    if (path.size() > fieldIndex + 3) {
+        shift = path.back();
+    }
+
+    if (shift < 0 || shift > 1) {
+        return role;
+    }
+
+    Register reg = GPR_FIELDS[field / 2];
+    if (reg == Register::None) {
+        role.location = shift == 0 ? Location::PC : Location::Other;
+    } else {
+        role.location = Location::Register;
+        role.alias = {reg, 0, (uint8_t)shift};
+    }
+
+    return role;
+}
@@ -0,0 +1,322 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <static/vsa/KnownBits.hpp>
+#include <static/vsa/RICKernels.hpp>
+
+/// Soundness check of the RIC kernels in `RICKernels.hpp`. At small widths,
+/// every pair of RICs (including ones with infinite bounds) is run through
+/// every kernel, and the result must contain the wrapped result of every
+/// pair of concrete elements. At 64 bits, values near the ends of the range
+/// are sampled instead, and the known-bits kernels and `reduce` are checked
+/// along with the RIC kernels.
+
+typedef RIC (*Kernel)(RIC, RIC, int);
+typedef KnownBits (*BitsKernel)(KnownBits, KnownBits);
+
+enum class Op {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    UDiv,
+    Rem,
+    URem,
+    Shl,
+    AShr,
+    LShr,
+    And,
+    Or,
+    Xor
+};
+
+struct KernelCase {
+    const char *name;
+    Op op;
+    Kernel kernel;
+    BitsKernel bitsKernel;
+};
+
+static const KernelCase CASES[] = {
+    {"add", Op::Add, RICKernels::add, KnownBitsKernels::add},
+    {"sub", Op::Sub, RICKernels::sub, KnownBitsKernels::sub},
+    {"mul", Op::Mul, RICKernels::mul, KnownBitsKernels::mul},
+    {"div", Op::Div, RICKernels::div, KnownBitsKernels::div},
+    {"udiv", Op::UDiv, RICKernels::udiv, KnownBitsKernels::udiv},
+    {"rem", Op::Rem, RICKernels::rem, KnownBitsKernels::rem},
+    {"urem", Op::URem, RICKernels::urem, KnownBitsKernels::urem},
+    {"shl", Op::Shl, RICKernels::shl, KnownBitsKernels::shl},
+    {"ashr", Op::AShr, RICKernels::ashr, KnownBitsKernels::ashr},
+    {"lshr", Op::LShr, RICKernels::lshr, KnownBitsKernels::lshr},
+    {"and", Op::And, RICKernels::bitAnd, KnownBitsKernels::bitAnd},
+    {"or", Op::Or, RICKernels::bitOr, KnownBitsKernels::bitOr},
+    {"xor", Op::Xor, RICKernels::bitXor, KnownBitsKernels::bitXor},
+};
+
+/// @brief The concrete result of `x op y` on `width`-bit values, as in
+/// LLVM.
+/// @return false if the result is undefined or poison
+static bool evaluate(Op op, int64_t x, int64_t y, int width,
+                     int64_t &result) {
+    uint64_t mask = width >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << width) - 1;
+    uint64_t ux = (uint64_t)x & mask, uy = (uint64_t)y & mask;
+    int64_t smallest = RICKernels::signExtend((int64_t)1 << (width - 1), width);
+
+    uint64_t value = 0;
+    switch (op) {
+    case Op::Add:
+        value = (uint64_t)x + (uint64_t)y;
+        break;
+    case Op::Sub:
+        value = (uint64_t)x - (uint64_t)y;
+        break;
+    case Op::Mul:
+        value = (uint64_t)x * (uint64_t)y;
+        break;
+    case Op::Div:
+    case Op::Rem:
+        if (y == 0 || (x == smallest && y == -1)) {
+            return false;
+        }
+        value = op == Op::Div ? x / y : x % y;
+        break;
+    case Op::UDiv:
+    case Op::URem:
+        if (uy == 0) {
+            return false;
+        }
+        value = op == Op::UDiv ? ux / uy : ux % uy;
+        break;
+    case Op::Shl:
+    case Op::AShr:
+    case Op::LShr:
+        if (y < 0 || y >= width) {
+            return false;
+        }
+        value = op == Op::Shl    ? (uint64_t)x << y
+                : op == Op::AShr ? (uint64_t)(x >> y)
+                                 : ux >> y;
+        break;
+    case Op::And:
+        value = x & y;
+        break;
+    case Op::Or:
+        value = x | y;
+        break;
+    case Op::Xor:
+        value = x ^ y;
+        break;
+    }
+
+    result = RICKernels::signExtend((int64_t)value, width);
+    return true;
+}
+
+/// Every RIC whose elements are all `width`-bit values, plus RICs with
+/// infinite bounds
+static std::vector<RIC> allRICs(int width) {
+    int64_t lo = RICKernels::minValue(width).getIntNumeral();
+    int64_t hi = RICKernels::maxValue(width).getIntNumeral();
+
+    std::vector<RIC> result;
+    for (int64_t first = lo; first <= hi; first++) {
+        result.push_back(RIC(first));
+
+        for (int64_t stride = 1; first + stride <= hi; stride++) {
+            for (int64_t count = 1; first + stride * count <= hi; count++) {
+                result.push_back(RIC(stride, 0, count, first));
+            }
+
+            // Only the residue matters with an infinite bound, so there is
+            // no need to go through every stride
+            if (stride <= hi + 1) {
+                result.push_back(
+                    RIC(stride, 0, Bound::plus_infinity(), first));
+                result.push_back(
+                    RIC(stride, Bound::minus_infinity(), 0, first));
+            }
+        }
+    }
+
+    for (int64_t stride = 1; stride <= hi + 1; stride++) {
+        for (int64_t residue = 0; residue < stride; residue++) {
+            result.push_back(RIC(stride, Bound::minus_infinity(),
+                                 Bound::plus_infinity(), residue));
+        }
+    }
+
+    return result;
+}
+
+/// The elements of `ric` that are `width`-bit values
+static std::vector<int64_t> elements(const RIC &ric, int width) {
+    std::vector<int64_t> result;
+    for (int64_t value = RICKernels::minValue(width).getIntNumeral();
+         value <= RICKernels::maxValue(width).getIntNumeral(); value++) {
+        if (RICKernels::contains(ric, value)) {
+            result.push_back(value);
+        }
+    }
+
+    return result;
+}
+
+static void report(const KernelCase &kernel, RIC lhs, RIC rhs, RIC result,
+                   int64_t x, int64_t y, int64_t value, int width) {
+    std::fprintf(stderr,
+                 "%s at width %d: %s, %s = %s, missing %lld %s %lld = %lld\n",
+                 kernel.name, width, lhs.toString().c_str(),
+                 rhs.toString().c_str(), result.toString().c_str(),
+                 (long long)x, kernel.name, (long long)y, (long long)value);
+}
+
+/// @return the number of unsound results at `width` bits
+static int checkWidth(int width) {
+    std::vector<RIC> rics = allRICs(width);
+
+    std::vector<std::vector<int64_t>> concrete;
+    for (RIC &ric : rics) {
+        concrete.push_back(elements(ric, width));
+    }
+
+    int failures = 0;
+    for (const KernelCase &kernel : CASES) {
+        for (size_t i = 0; i < rics.size(); i++) {
+            for (size_t j = 0; j < rics.size(); j++) {
+                RIC result = kernel.kernel(rics[i], rics[j], width);
+
+                bool sound = true;
+                for (int64_t x : concrete[i]) {
+                    for (int64_t y : concrete[j]) {
+                        int64_t value;
+                        if (evaluate(kernel.op, x, y, width, value) &&
+                            !RICKernels::contains(result, value)) {
+                            report(kernel, rics[i], rics[j], result, x, y,
+                                   value, width);
+                            sound = false;
+                            break;
+                        }
+                    }
+
+                    if (!sound) {
+                        break;
+                    }
+                }
+
+                if (!sound && ++failures >= 10) {
+                    return failures;
+                }
+            }
+        }
+    }
+
+    return failures;
+}
+
+/// @brief Random 64-bit RICs and elements of them, clustered around 0,
+/// the ends of the `int` range and the ends of the 64-bit range, where
+/// arithmetic wraps.
+static RIC randomRIC(std::mt19937_64 &rng, int64_t &element) {
+    static const int64_t centres[] = {0,          62,         INT32_MAX,
+                                      INT32_MIN,  (int64_t)1 << 62,
+                                      -((int64_t)1 << 62),    INT64_MAX - 8,
+                                      INT64_MIN + 8};
+
+    RIC ric;
+    int64_t first;
+
+    // The bounds of a RIC are computed as `offset + stride * start`, which
+    // saturates if `stride * start` doesn't fit, so skip those RICs
+    do {
+        int64_t centre = centres[rng() % 8];
+        first = centre + (int64_t)(rng() % 9) - 4;
+        int stride = 1 + rng() % 8;
+        int64_t count = rng() % 4;
+
+        // Keep the range inside the finite bounds
+        if (first > INT64_MAX - 1 - stride * count) {
+            first -= stride * count;
+        }
+
+        element = first + stride * (int64_t)(rng() % (count + 1));
+
+        // Split `first` so that the offset fits in an `int`
+        int64_t index = first / stride, residue = first % stride;
+        if (residue < 0) {
+            index--;
+            residue += stride;
+        }
+
+        ric = RIC(stride, index, index + count, (int)residue);
+        if (count == 0 && RICKernels::fitsInt(first)) {
+            ric = RIC((int)first);
+        }
+    } while (ric.lower().is_infinity() || ric.upper().is_infinity());
+
+    // Sometimes forget the upper bound, which keeps `element`
+    if (rng() % 4 == 0 && first >= 0) {
+        ric = RIC(1, 0, Bound::plus_infinity(), 0);
+    }
+
+    return ric;
+}
+
+/// @return the number of unsound results at 64 bits, with known bits
+static int checkWords() {
+    std::mt19937_64 rng(20261016);
+
+    int failures = 0;
+    for (const KernelCase &kernel : CASES) {
+        for (int i = 0; i < 200000 && failures < 10; i++) {
+            int64_t x, y;
+            RIC lhs = randomRIC(rng, x);
+            RIC rhs = randomRIC(rng, y);
+
+            // Shift amounts are small
+            if (kernel.op == Op::Shl || kernel.op == Op::AShr ||
+                kernel.op == Op::LShr) {
+                y = rng() % 64;
+                rhs = RIC((int)y);
+            }
+
+            int64_t value;
+            if (!evaluate(kernel.op, x, y, 64, value)) {
+                continue;
+            }
+
+            RIC result = kernel.kernel(lhs, rhs, 64);
+            KnownBits bits = kernel.bitsKernel(
+                KnownBitsKernels::fromRIC(lhs), KnownBitsKernels::fromRIC(rhs));
+            reduce(result, bits);
+
+            bool bitsMatch = ((uint64_t)value & bits.zeros) == 0 &&
+                             ((uint64_t)value & bits.ones) == bits.ones;
+
+            if (!RICKernels::contains(result, value) || !bitsMatch) {
+                report(kernel, lhs, rhs, result, x, y, value, 64);
+                failures++;
+            }
+        }
+    }
+
+    return failures;
+}
+
+// 7 << 62 wraps around to -2^62, which isn't a multiple of 7
+static_assert(RICKernels::contains(RICKernels::shl(RIC(7), RIC(62)),
+                                   -((int64_t)1 << 62)),
+              "shl must account for wrapping");
+
+int main() {
+    int failures = 0;
+
+    for (int width = 2; width <= 4; width++) {
+        failures += checkWidth(width);
+    }
+
+    failures += checkWords();
+
+    return failures == 0 ? 0 : 1;
+}
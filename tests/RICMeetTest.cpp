@@ -0,0 +1,154 @@
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <static/vsa/RIC.hpp>
+
+/// Randomised check of `RIC::meetWith` against a reference that finds the
+/// common residue class with the candidate loop `meetWith` used before it
+/// was computed in closed form, including RICs with infinite bounds and
+/// strides whose LCM doesn't fit in an `int`.
+
+/// Whether `value` is an element of `ric`
+static bool member(const RIC &ric, int64_t value) {
+    if (ric.isBottom() || value < ric.lower() || value > ric.upper()) {
+        return false;
+    }
+
+    int64_t diff = value - ric.offset;
+    if (diff % ric.stride != 0) {
+        return false;
+    }
+
+    Bound index = diff / ric.stride;
+    return index >= ric.start && index <= ric.end;
+}
+
+/// @brief The reference: step through the elements of one residue class
+/// until one of them is also in the other residue class.
+/// @return false if the two residue classes never meet
+static bool referenceResidue(RIC lhs, RIC rhs, int64_t &first) {
+    if (lhs.stride < rhs.stride) {
+        std::swap(lhs, rhs);
+    }
+
+    for (int64_t i = 0; i < rhs.stride; i++) {
+        int64_t candidate = lhs.offset + i * lhs.stride;
+        if ((candidate - rhs.offset) % rhs.stride == 0) {
+            first = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static RIC randomRIC(std::mt19937_64 &rng) {
+    // Mostly small strides, with some large primes so that the LCM of two
+    // strides can overflow an `int`
+    static const int largeStrides[] = {46337, 65521, 65519, 99991, 104729};
+
+    int stride;
+    if (rng() % 4 == 0) {
+        stride = largeStrides[rng() % 5];
+    } else {
+        stride = 1 + rng() % 12;
+    }
+
+    int offset = (int)(rng() % 201) - 100;
+
+    Bound start = (int64_t)(rng() % 21) - 10;
+    Bound end = start + (int64_t)(rng() % 21);
+
+    switch (rng() % 4) {
+    case 0:
+        start = Bound::minus_infinity();
+        break;
+    case 1:
+        end = Bound::plus_infinity();
+        break;
+    case 2:
+        if (rng() % 4 == 0) {
+            start = Bound::minus_infinity();
+            end = Bound::plus_infinity();
+        }
+        break;
+    default:
+        break;
+    }
+
+    return RIC(stride, start, end, offset);
+}
+
+/// Values around which the meet of `lhs` and `rhs` is checked: a window
+/// around 0, and the first few common elements from either end of the
+/// overlapping range
+static std::vector<int64_t> probes(const RIC &lhs, const RIC &rhs) {
+    std::vector<int64_t> result;
+    for (int64_t value = -200; value <= 200; value++) {
+        result.push_back(value);
+    }
+
+    int64_t first;
+    if (!referenceResidue(lhs, rhs, first)) {
+        return result;
+    }
+
+    int64_t lcm = std::lcm((int64_t)lhs.stride, (int64_t)rhs.stride);
+    Bound lower = std::max(lhs.lower(), rhs.lower());
+    Bound upper = std::min(lhs.upper(), rhs.upper());
+
+    // Move `first` to the common element closest to each finite end
+    auto align = [&](int64_t bound) {
+        int64_t diff = (bound - first) % lcm;
+        return bound - (diff < 0 ? diff + lcm : diff);
+    };
+
+    for (int64_t k = -3; k <= 3; k++) {
+        result.push_back(first + k * lcm);
+        if (!lower.is_infinity()) {
+            result.push_back(align(lower.getIntNumeral()) + k * lcm);
+        }
+        if (!upper.is_infinity()) {
+            result.push_back(align(upper.getIntNumeral()) + k * lcm);
+        }
+    }
+
+    return result;
+}
+
+int main() {
+    std::mt19937_64 rng(20261016);
+    int failures = 0;
+
+    for (int i = 0; i < 100000 && failures < 10; i++) {
+        RIC lhs = randomRIC(rng);
+        RIC rhs = randomRIC(rng);
+
+        RIC result = lhs;
+        result.meetWith(rhs);
+
+        // A meet is only exact if its stride fits in an `int`
+        bool exact =
+            std::lcm((int64_t)lhs.stride, (int64_t)rhs.stride) <= INT32_MAX;
+
+        for (int64_t value : probes(lhs, rhs)) {
+            bool inBoth = member(lhs, value) && member(rhs, value);
+            bool inResult = member(result, value);
+
+            if (inBoth != inResult && (inBoth || exact)) {
+                std::fprintf(stderr, "%s meet %s = %s, %s %lld\n",
+                             lhs.toString().c_str(), rhs.toString().c_str(),
+                             result.toString().c_str(),
+                             inBoth ? "missing" : "extra", (long long)value);
+                failures++;
+                break;
+            }
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
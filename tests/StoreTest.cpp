@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <static/vsa/ALocStore.hpp>
+#include <static/vsa/StoreMap.hpp>
+
+/// Check of the persistent stores in `ALocStore.hpp` and `StoreMap.hpp`
+/// against a `std::map` of the same entries. Stores are copied and written
+/// to in every order that the sharing and versioning of their chunks and
+/// leaves has to handle: copies written on both sides, stores written in
+/// place after being copied from, joins that add missing entries and leaves
+/// that split once they are full. Values are handles that are never looked
+/// up, so no value sets are interned.
+
+typedef std::map<uint32_t, uint32_t> Reference;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what, int step) {
+    if (!ok) {
+        std::fprintf(stderr, "%s (step %d)\n", what, step);
+        failures++;
+    }
+}
+
+static ValueSetRef value(uint32_t id) { return ValueSetRef::fromId(id); }
+
+/// Join of two handles, which only needs to leave a value unchanged when
+/// combined with itself
+static ValueSetRef combineMax(ValueSetRef lhs, ValueSetRef rhs) {
+    return value(std::max(lhs.getId(), rhs.getId()));
+}
+
+static void combineReference(Reference &lhs, const Reference &rhs,
+                             bool addMissing) {
+    for (auto &kv : rhs) {
+        auto it = lhs.find(kv.first);
+        if (it != lhs.end()) {
+            it->second = std::max(it->second, kv.second);
+        } else if (addMissing) {
+            lhs.insert(kv);
+        }
+    }
+}
+
+static Reference contents(const ALocStore &store) {
+    Reference result;
+    for (auto entry : store) {
+        result[entry.id] = entry.second.getId();
+    }
+
+    return result;
+}
+
+static Reference contents(const StoreMap<uint32_t> &map) {
+    Reference result;
+    uint32_t previous = 0;
+    bool first = true;
+
+    for (auto entry : map) {
+        // Entries must come out in key order, across every leaf
+        check(first || previous < entry.first, "StoreMap out of order", -1);
+        previous = entry.first;
+        first = false;
+
+        result[entry.first] = entry.second.getId();
+    }
+
+    return result;
+}
+
+/// @brief Run random writes, copies and joins over a few stores of type
+/// `Store`, checking every store against its reference after each step.
+/// @param keys keys are drawn from [0, keys), so that stores span several
+/// chunks or leaves
+template <typename Store> static void checkRandom(uint32_t keys, int steps) {
+    const int STORES = 4;
+    std::mt19937 rng(20261016);
+
+    Store stores[STORES];
+    Reference references[STORES];
+
+    for (int step = 0; step < steps; step++) {
+        int i = rng() % STORES, j = rng() % STORES;
+
+        switch (rng() % 8) {
+        case 0:
+        case 1:
+        case 2: {
+            // Write - sometimes the same value as another store, so that
+            // unshared chunks end up equal again
+            uint32_t key = rng() % keys;
+            uint32_t id = 1 + rng() % 4;
+            stores[i][key] = value(id);
+            references[i][key] = id;
+            break;
+        }
+        case 3:
+            stores[i] = stores[j];
+            references[i] = references[j];
+            break;
+        case 4:
+        case 5: {
+            bool addMissing = rng() % 2;
+            bool changed =
+                stores[i].combineWith(stores[j], combineMax, addMissing);
+
+            Reference before = references[i];
+            combineReference(references[i], references[j], addMissing);
+            check(changed == (before != references[i]),
+                  "combineWith reported the wrong change", step);
+            break;
+        }
+        case 6:
+            if (rng() % 16 == 0) {
+                stores[i].clear();
+                references[i].clear();
+            }
+            break;
+        default:
+            check((stores[i] == stores[j]) == (references[i] == references[j]),
+                  "stores compared wrongly", step);
+            break;
+        }
+
+        check(contents(stores[i]) == references[i], "store lost a write",
+              step);
+        check(stores[i].size() == references[i].size(), "wrong size", step);
+    }
+}
+
+/// Copies written to on both sides, in the same chunk and in different
+/// chunks, then compared
+static void checkCopies() {
+    ALocStore lhs;
+    for (ALocID id = 0; id < 200; id++) {
+        lhs[id] = value(1);
+    }
+
+    ALocStore rhs = lhs;
+    lhs[3] = value(2);
+    rhs[70] = value(2);
+    check(!(lhs == rhs), "copies written on both sides are equal", 0);
+
+    lhs[70] = value(2);
+    rhs[3] = value(2);
+    check(lhs == rhs, "copies with the same writes differ", 1);
+
+    // Both sides write the same entry, then only one side writes another
+    lhs[5] = value(3);
+    rhs[5] = value(3);
+    rhs[6] = value(3);
+    check(!(lhs == rhs), "copies written in the same chunk are equal", 2);
+
+    lhs[6] = value(3);
+    check(lhs == rhs, "copies written in the same chunk differ", 3);
+}
+
+/// A store written in place after a copy of it was written to, so that the
+/// copy's base version is stale
+static void checkStaleBase() {
+    ALocStore base;
+    base[1] = value(1);
+    base[2] = value(1);
+
+    ALocStore copy = base;
+    copy[1] = value(2);
+
+    // `copy` now owns its own chunk, and `base` is the only owner of the
+    // original one, so both of these write in place
+    base[1] = value(2);
+    base[2] = value(3);
+    check(!(copy == base), "in-place write after a copy was missed", 0);
+    check(!(base == copy), "in-place write after a copy was missed", 1);
+
+    copy[2] = value(3);
+    check(copy == base, "stores with the same writes differ", 2);
+
+    // Only one side is written again, away from the entries written so far
+    base[40] = value(4);
+    copy[40] = value(4);
+    base[41] = value(4);
+    check(!(copy == base), "one-sided write after a copy was missed", 3);
+}
+
+/// Joins that add a-locs which are only in the other store
+static void checkJoin() {
+    ALocStore lhs, rhs;
+    lhs[0] = value(1);
+    lhs[5] = value(2);
+    rhs[5] = value(3);
+    rhs[71] = value(4);
+    rhs[200] = value(5);
+
+    ALocStore narrowed = lhs;
+    check(narrowed.combineWith(rhs, combineMax, false), "no change", 0);
+    check(contents(narrowed) == Reference{{0, 1}, {5, 3}},
+          "join without missing a-locs added some", 1);
+
+    check(lhs.combineWith(rhs, combineMax, true), "no change", 2);
+    check(contents(lhs) ==
+              Reference{{0, 1}, {5, 3}, {71, 4}, {200, 5}},
+          "join lost missing a-locs", 3);
+    check(!lhs.combineWith(rhs, combineMax, true), "second join changed", 4);
+
+    // Joining into an empty store shares the other store
+    ALocStore empty;
+    check(empty.combineWith(rhs, combineMax, true), "no change", 5);
+    check(empty == rhs, "join into an empty store differs", 6);
+}
+
+/// Leaves split past `LEAF_CAPACITY`, with keys added at the end, at the
+/// start and in the middle of the map
+static void checkSplits() {
+    const uint32_t COUNT = 5 * StoreMap<uint32_t>::LEAF_CAPACITY;
+
+    std::vector<uint32_t> ascending, descending, shuffled;
+    for (uint32_t key = 0; key < COUNT; key++) {
+        ascending.push_back(key);
+    }
+
+    descending.assign(ascending.rbegin(), ascending.rend());
+    shuffled = ascending;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(20261016));
+
+    int order = 0;
+    for (const std::vector<uint32_t> *keys :
+         {&ascending, &descending, &shuffled}) {
+        StoreMap<uint32_t> map;
+        Reference reference;
+
+        for (uint32_t key : *keys) {
+            // Keep a copy from before the write, which must not change
+            StoreMap<uint32_t> before = map;
+            Reference beforeReference = reference;
+
+            map[key] = value(key + 1);
+            reference[key] = key + 1;
+
+            check(contents(before) == beforeReference,
+                  "split changed a copy", order);
+        }
+
+        check(contents(map) == reference, "split lost an entry", order);
+        for (uint32_t key = 0; key < COUNT; key++) {
+            auto it = map.find(key);
+            check(it != map.end() && (*it).second == value(key + 1),
+                  "split key can't be found", order);
+        }
+
+        check(map.find(COUNT) == map.end(), "found a missing key", order);
+        order++;
+    }
+}
+
+int main() {
+    checkCopies();
+    checkStaleBase();
+    checkJoin();
+    checkSplits();
+
+    checkRandom<ALocStore>(4 * ALocStore::CHUNK, 200000);
+    checkRandom<StoreMap<uint32_t>>(4 * StoreMap<uint32_t>::LEAF_CAPACITY,
+                                    200000);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <static/vsa/VarRole.hpp>
+
+/// Check of the variable roles found from the structure of Remill-lifted
+/// bitcode, on a lifted binary such as `examples/vuln.ll`. Every GEP off
+/// the state pointer is classified by its field path alone, and then
+/// checked against Remill's name for it, as are the roles resolved for
+/// every load and store through one.
+
+static const char *roleName(const VarRole &role) {
+    switch (role.location) {
+    case Location::PC:
+        return "PC";
+    case Location::NextPC:
+        return "NEXT_PC";
+    case Location::ReturnPC:
+        return "RETURN_PC";
+    case Location::FrameBase:
+        return "frame base";
+    case Location::Register:
+        return "register";
+    default:
+        return "other";
+    }
+}
+
+static void report(int line, const std::string &name, const VarRole &role,
+                   const char *problem) {
+    std::fprintf(stderr,
+                 "line %d: %%%s is %s (reg %d, width %d, shift %d), %s\n",
+                 line, name.c_str(), roleName(role), (int)role.alias.reg,
+                 (int)role.alias.width, (int)role.alias.shift, problem);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <lifted.ll>\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream file(argv[1]);
+    if (!file) {
+        std::fprintf(stderr, "can't open %s\n", argv[1]);
+        return 1;
+    }
+
+    static const std::regex GEP(
+        R"(%(\w+) = getelementptr inbounds %struct\.(?:X86)?State, )"
+        R"(ptr %state((?:, i\d+ -?\d+)+)$)");
+    static const std::regex INDEX(R"(i\d+ (-?\d+))");
+    static const std::regex ACCESS(
+        R"((?:load i(\d+), ptr %(\w+)|store i(\d+) [^,]+, ptr %(\w+)))");
+
+    std::map<std::string, VarRole> roles;
+    int failures = 0;
+    int lineNumber = 0;
+    std::string line;
+
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::smatch match;
+
+        if (std::regex_search(line, match, GEP)) {
+            std::vector<int64_t> path;
+            std::string indices = match[2];
+            for (std::sregex_iterator it(indices.begin(), indices.end(),
+                                         INDEX);
+                 it != std::sregex_iterator(); ++it) {
+                path.push_back(std::stoll((*it)[1]));
+            }
+
+            std::string name = match[1];
+            VarRole role = VarRole::fromStatePath(path);
+            roles[name] = role;
+
+            VarRole named = VarRole::fromName(name);
+            if (named.location != Location::Other &&
+                !role.agreesWith(named)) {
+                report(lineNumber, name, role, "which disagrees with its name");
+                failures++;
+            }
+        } else if (std::regex_search(line, match, ACCESS)) {
+            bool isLoad = match[1].matched;
+            std::string name = isLoad ? match[2] : match[4];
+            int bits = std::stoi(isLoad ? match[1] : match[3]);
+
+            auto it = roles.find(name);
+            if (it == roles.end()) {
+                continue;
+            }
+
+            // An access through a named register pointer is exactly the
+            // register (or part of one) that it's named after
+            VarRole role = it->second.resolve(bits / 8);
+            VarRole named = VarRole::fromName(name);
+            if (named.location != Location::Other && role != named) {
+                report(lineNumber, name, role,
+                       "which isn't the part of the register it names");
+                failures++;
+            }
+        }
+    }
+
+    // The registers and PC that every lifted function uses
+    for (const char *name : {"RAX", "RSP", "RBP", "PC"}) {
+        auto it = roles.find(name);
+        if (it == roles.end() || it->second.location == Location::Other) {
+            std::fprintf(stderr, "%%%s isn't classified\n", name);
+            failures++;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}